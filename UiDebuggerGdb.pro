@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -27,11 +27,55 @@ SOURCES += main.cpp\
         mainwindow.cpp \
     gdb.cpp \
     breakpoint.cpp \
-    variable.cpp
+    variable.cpp \
+    mirecord.cpp \
+    milinesplitter.cpp \
+    hitlog.cpp \
+    hitlogmodel.cpp \
+    watchlist.cpp \
+    structurewalk.cpp \
+    registers.cpp \
+    disassembly.cpp \
+    sourceview.cpp \
+    startup.cpp \
+    symbolindex.cpp \
+    coresnapshot.cpp \
+    statesnapshot.cpp \
+    printcapture.cpp \
+    inferiorterminal.cpp \
+    commandscheduler.cpp \
+    sessionlog.cpp \
+    watchhistory.cpp \
+    timetravel.cpp \
+    evaluator.cpp \
+    inferiors.cpp
 
 HEADERS  += mainwindow.h \
     gdb.h \
     breakpoint.h \
-    variable.h
+    variable.h \
+    mirecord.h \
+    milinesplitter.h \
+    hitlog.h \
+    hitlogmodel.h \
+    watchlist.h \
+    structurewalk.h \
+    registers.h \
+    disassembly.h \
+    sourceview.h \
+    startup.h \
+    symbolindex.h \
+    coresnapshot.h \
+    statesnapshot.h \
+    printcapture.h \
+    inferiorterminal.h \
+    commandscheduler.h \
+    sessionlog.h \
+    watchhistory.h \
+    timetravel.h \
+    evaluator.h \
+    inferiors.h
 
-FORMS    += mainwindow.ui \
+FORMS    += mainwindow.ui
+
+RESOURCES += helpers.qrc
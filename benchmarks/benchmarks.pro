@@ -0,0 +1,34 @@
+#-------------------------------------------------
+#
+# Micro-benchmarks of GDB output parsers, built separately from UiDebuggerGdb.
+# Run release build: benchmarks --baseline baseline.txt [--save]
+# baseline.txt is for the reference build machine, regenerate it there with --save
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = benchmarks
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+INCLUDEPATH += ..
+
+SOURCES += main.cpp \
+    generators.cpp \
+    ../mirecord.cpp \
+    ../breakpoint.cpp \
+    ../variable.cpp \
+    ../printcapture.cpp \
+    ../milinesplitter.cpp
+
+HEADERS  += generators.h \
+    ../mirecord.h \
+    ../breakpoint.h \
+    ../variable.h \
+    ../printcapture.h \
+    ../milinesplitter.h
@@ -0,0 +1,123 @@
+#include "generators.h"
+
+#include "../mirecord.h"
+
+namespace Generators
+{
+
+static QString element(int index)
+{   // one field as GDB prints it: numbers, pointer, string, nested structure and array
+    return QString("f%1 = {id = %1, name = \"item %1\", next = 0x%2, pos = {x = %3, y = -%3}, "
+                   "flags = {true, false, true}, weight = %4}")
+            .arg(index).arg(0x603000 + index*32, 0, 16).arg(index % 1000).arg(index * 0.5);
+}
+
+QString structDump(int targetSize)
+{   //structure of ~$targetSize$ characters with fields of every kind
+    QString dump("{");
+    dump.reserve(targetSize + 256);
+    for(int i = 0; dump.size() < targetSize; ++i)
+    {
+        if(i != 0)
+        {
+            dump.append(", ");
+        }
+        dump.append(element(i));
+    }
+    dump.append('}');
+    return dump;
+}
+
+QString nestedStruct(int depth)
+{   //{level = 0, next = {level = 1, next = {... {level = N, next = 0x0}}}}
+    QString dump;
+    for(int i = 0; i < depth; ++i)
+    {
+        dump.append(QString("{level = %1, next = ").arg(i));
+    }
+    dump.append("0x0");
+    dump.append(QString(depth, '}'));
+    return dump;
+}
+
+QString pathologicalString(int length)
+{   //structure with string full of escapes, quotes, braces, commas and " = " which parsers
+    //have to skip without taking them for structure
+    static const QString pattern("\\\"{a = 1, b = {}}\\\\\\\", '}' = ,\\t\\n");
+    QString text;
+    text.reserve(length + pattern.size());
+    while(text.size() < length)
+    {
+        text.append(pattern);
+    }
+    return QString("{text = \"%1\", tail = {c = '\"', d = '{'}, last = 1}").arg(text);
+}
+
+QString breakpointTable(int count)
+{   //result of -break-list with $count$ breakpoints
+    QString table("^done,BreakpointTable={nr_rows=\"%1\",nr_cols=\"6\",hdr=[{width=\"3\",alignment=\"-1\","
+                  "col_name=\"number\",colhdr=\"Num\"}],body=[");
+    table = table.arg(count);
+    for(int i = 1; i <= count; ++i)
+    {
+        if(i != 1)
+        {
+            table.append(',');
+        }
+        table.append(QString("bkpt={number=\"%1\",type=\"breakpoint\",disp=\"%2\",enabled=\"%3\","
+                             "addr=\"0x%4\",func=\"ns::Class::method%5(int, char const*)\",file=\"src/file%6.cpp\","
+                             "fullname=\"/home/user/project/src/file%6.cpp\",line=\"%7\",cond=\"i == %1\","
+                             "thread-groups=[\"i1\"],times=\"%8\",ignore=\"0\",original-location=\"file%6.cpp:%7\"}")
+                     .arg(i).arg(i % 7 == 0 ? "del" : "keep").arg(i % 3 == 0 ? "n" : "y")
+                     .arg(0x401000 + i*16, 0, 16).arg(i % 500).arg(i % 200).arg(i % 5000 + 1).arg(i % 11));
+    }
+    table.append("]}");
+    return table;
+}
+
+QStringList breakpointLines(int count)
+{   //lines of CLI "info b" as they come in console records
+    QStringList lines;
+    lines.reserve(count);
+    for(int i = 1; i <= count; ++i)
+    {
+        lines << QString("\"%1       breakpoint     %2 %3   0x%4 in method%5(int, char) at file%6.cpp:%7\\n\"")
+                 .arg(i).arg(i % 7 == 0 ? "del " : "keep").arg(i % 3 == 0 ? "n" : "y")
+                 .arg(0x401000 + i*16, 8, 16, QChar('0')).arg(i % 500).arg(i % 200).arg(i % 5000 + 1);
+    }
+    return lines;
+}
+
+QStringList consoleRecords(const QString &value, int chunkSize)
+{   //$value$ printed by GDB as console stream records
+    QStringList records;
+    for(int i = 0; i < value.size(); i += chunkSize)
+    {
+        records << QString("~%1").arg(MiRecord::quote(value.mid(i, chunkSize)));
+    }
+    return records;
+}
+
+QStringList printChunks(const QString &value, int chunkSize)
+{   //already unquoted console output of "print", like PrintCapture gets it
+    QStringList chunks;
+    QString text = QString("$1 = %1\n").arg(value);
+    for(int i = 0; i < text.size(); i += chunkSize)
+    {
+        chunks << text.mid(i, chunkSize);
+    }
+    return chunks;
+}
+
+QList<QByteArray> outputChunks(const QString &value, int chunkSize)
+{   //$value$ as one console record read from GDB by chunks of $chunkSize$ bytes
+    QList<QByteArray> chunks;
+    QByteArray line = QString("~%1\n").arg(MiRecord::quote(value)).toUtf8();
+    for(int i = 0; i < line.size(); i += chunkSize)
+    {
+        chunks << line.mid(i, chunkSize);
+    }
+    return chunks;
+}
+
+}
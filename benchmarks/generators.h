@@ -0,0 +1,24 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/* Synthetic GDB output for benchmarks. Every generator is deterministic, so numbers of
+   different runs are comparable with stored baseline */
+
+namespace Generators
+{
+    QString structDump(int targetSize);
+    QString nestedStruct(int depth);
+    QString pathologicalString(int length);
+    QString breakpointTable(int count);
+    QStringList breakpointLines(int count);
+    QStringList consoleRecords(const QString& value, int chunkSize);
+    QStringList printChunks(const QString& value, int chunkSize);
+    QList<QByteArray> outputChunks(const QString& value, int chunkSize);
+}
+
+#endif // GENERATORS_H
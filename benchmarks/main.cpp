@@ -0,0 +1,384 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "../mirecord.h"
+#include "../breakpoint.h"
+#include "../variable.h"
+#include "../printcapture.h"
+#include "../milinesplitter.h"
+#include "generators.h"
+
+/* Micro-benchmarks of parsers and models on synthetic GDB output.
+   Usage: benchmarks [--filter TEXT] [--baseline FILE] [--save]
+   Every benchmark is repeated until it took minTime, the best run is reported. With baseline
+   file numbers are compared with stored ones, --save writes current numbers there.
+   baseline.txt next to this file holds numbers of the reference build machine described at its
+   top, after intended change of speed they are regenerated there by release build with
+   benchmarks --baseline baseline.txt --save */
+
+static std::atomic<qint64> allocations{0};
+
+/* Qt containers allocate with malloc, operators new don't see them. With glibc malloc itself
+   is replaced, so every allocation is counted */
+#ifdef __GLIBC__
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+
+extern "C" void* malloc(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" void* calloc(size_t count, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+#else
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void* pointer = std::malloc(size ? size : 1))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+#endif
+
+static const qint64 minTime = 500;  // ms each benchmark is repeated
+static const int maxRuns = 50;
+
+struct Benchmark
+{
+    QString name;
+    qint64 bytes;       // input size of one operation
+    qint64 operations;  // items processed by one run, results are per item
+    std::function<void()> run;
+};
+
+struct Result
+{
+    double nsPerOperation = 0;
+    double allocationsPerOperation = 0;
+    double megabytesPerSecond = 0;
+};
+
+static Result measure(const Benchmark& benchmark)
+{   //the first run counts allocations and warms caches, the best of the rest is reported
+    Result result;
+    qint64 before = allocations.load();
+    benchmark.run();
+    result.allocationsPerOperation = double(allocations.load() - before) / benchmark.operations;
+    QElapsedTimer total;
+    total.start();
+    qint64 best = -1;
+    for(int i = 0; i < maxRuns && (i == 0 || total.elapsed() < minTime); ++i)
+    {
+        QElapsedTimer clock;
+        clock.start();
+        benchmark.run();
+        qint64 elapsed = clock.nsecsElapsed();
+        best = best == -1 ? elapsed : std::min(best, elapsed);
+    }
+    result.nsPerOperation = double(best) / benchmark.operations;
+    result.megabytesPerSecond = best > 0 ? benchmark.bytes / (1024.0*1024) / (best / 1e9) : 0;
+    return result;
+}
+
+static std::map<QString, Result> readBaseline(const QString& fileName)
+{   //lines "name ns-per-op allocations-per-op"
+    std::map<QString, Result> baseline;
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return baseline;
+    }
+    QTextStream stream(&file);
+    while(!stream.atEnd())
+    {
+        QStringList fields = stream.readLine().split(' ', QString::SkipEmptyParts);
+        if(fields.size() != 3 || fields[0].startsWith('#'))
+        {
+            continue;
+        }
+        Result& result = baseline[fields[0]];
+        result.nsPerOperation = fields[1].toDouble();
+        result.allocationsPerOperation = fields[2].toDouble();
+    }
+    return baseline;
+}
+
+static bool saveBaseline(const QString& fileName, const std::vector<std::pair<QString, Result>>& results)
+{   //comments at the top of existing file, such as description of the machine, are kept
+    QStringList comments;
+    QFile file(fileName);
+    if(file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        QTextStream stream(&file);
+        QString line;
+        while(!stream.atEnd() && (line = stream.readLine()).startsWith('#'))
+        {
+            comments << line;
+        }
+        file.close();
+    }
+    if(comments.isEmpty())
+    {
+        comments << "# name ns-per-op allocations-per-op";
+    }
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        return false;
+    }
+    QTextStream stream(&file);
+    stream << comments.join('\n') << '\n';
+    for(const auto& i : results)
+    {
+        stream << i.first << ' ' << QString::number(i.second.nsPerOperation, 'f', 2) << ' '
+               << QString::number(i.second.allocationsPerOperation, 'f', 2) << '\n';
+    }
+    return true;
+}
+
+static std::vector<Benchmark> createBenchmarks()
+{   //inputs are generated once, runs only parse them
+    std::vector<Benchmark> benchmarks;
+    auto bytes = [](const QStringList& list)
+    {
+        qint64 size = 0;
+        for(const QString& i : list)
+        {
+            size += i.size()*2;
+        }
+        return size;
+    };
+
+    const int breakpointCount = 100000;
+    QString table = Generators::breakpointTable(breakpointCount);
+    benchmarks.push_back({"mi/break-list-100k", table.size()*2, 1, [table]()
+    {
+        MiRecord::parse(table);
+    }});
+    std::shared_ptr<MiRecord> parsedTable = std::make_shared<MiRecord>(MiRecord::parse(table));
+    benchmarks.push_back({"breakpoint/parse-mi-100k", table.size()*2, breakpointCount, [parsedTable]()
+    {
+        const MiValue& body = (*parsedTable)["BreakpointTable"]["body"];
+        Breakpoint breakpoint;
+        for(int i = 0; i < body.size(); ++i)
+        {
+            breakpoint.parse(body.at(i));
+        }
+    }});
+    QStringList lines = Generators::breakpointLines(breakpointCount);
+    benchmarks.push_back({"breakpoint/parse-cli-100k", bytes(lines), breakpointCount, [lines]()
+    {
+        Breakpoint breakpoint;
+        for(const QString& i : lines)
+        {
+            breakpoint.parse(i);
+        }
+    }});
+
+    const int dumpSize = 10*1024*1024;
+    QString dump = Generators::structDump(dumpSize);
+    benchmarks.push_back({"variable/nested-types-10mb", dump.size()*2, 1, [dump]()
+    {
+        Variable("dump", "struct big", dump).getNestedTypes();
+    }});
+    benchmarks.push_back({"variable/read-nested-struct-10mb", dump.size()*2, 1, [dump]()
+    {
+        Variable().readNestedStruct(dump);
+    }});
+    QStringList records = Generators::consoleRecords(dump, 4096);
+    benchmarks.push_back({"mi/console-stream-10mb", bytes(records), records.size(), [records]()
+    {
+        for(const QString& i : records)
+        {
+            MiRecord::parse(i);
+        }
+    }});
+    QStringList chunks = Generators::printChunks(dump, 4096);
+    benchmarks.push_back({"print-capture/stream-10mb", bytes(chunks), 1, [chunks]()
+    {
+        PrintCapture capture("dump");
+        for(const QString& i : chunks)
+        {
+            capture.append(i);
+        }
+        capture.finish(true);
+    }});
+
+    QString longLine = Generators::structDump(50*1024*1024);
+    QList<QByteArray> outputChunks = Generators::outputChunks(longLine, 64*1024);
+    longLine.clear();
+    qint64 outputBytes = 0;
+    for(const QByteArray& i : outputChunks)
+    {
+        outputBytes += i.size();
+    }
+    benchmarks.push_back({"mi/split-line-50mb", outputBytes, 1, [outputChunks]()
+    {   // one record comes by many reads, each of them must not rescan what came before
+        MiLineSplitter splitter;
+        QString line;
+        for(const QByteArray& i : outputChunks)
+        {
+            splitter.append(i);
+            while(splitter.next(line))
+            {
+            }
+        }
+    }});
+
+    QString nested = Generators::nestedStruct(1000);
+    benchmarks.push_back({"variable/deep-nesting-1k", nested.size()*2, 1, [nested]()
+    {   // the whole chain, every level is parsed from the shared buffer
+        std::vector<Variable> level = Variable("node", "struct node", nested).getNestedTypes();
+        while(!level.empty())
+        {
+            Variable next;
+            bool found = false;
+            for(const Variable& i : level)
+            {
+                if(i.getLeafName().endsWith("next"))
+                {
+                    next = i;
+                    found = true;
+                }
+            }
+            level = found ? next.getNestedTypes() : std::vector<Variable>();
+        }
+    }});
+    QStringList nestedChunks = Generators::printChunks(nested, 4096);
+    benchmarks.push_back({"print-capture/deep-nesting-1k", bytes(nestedChunks), 1, [nestedChunks]()
+    {
+        PrintCapture capture("node");
+        for(const QString& i : nestedChunks)
+        {
+            capture.append(i);
+        }
+        capture.finish(true);
+        std::vector<PrintCapture::Field> fields = capture.getFields();
+        while(fields.size() == 2)
+        {
+            fields = capture.readFields(fields[1], capture.size());
+        }
+    }});
+
+    QString pathological = Generators::pathologicalString(1024*1024);
+    benchmarks.push_back({"variable/pathological-string-1mb", pathological.size()*2, 1, [pathological]()
+    {
+        Variable("text", "struct text", pathological).getNestedTypes();
+    }});
+    QStringList pathologicalRecords = Generators::consoleRecords(pathological, 4096);
+    benchmarks.push_back({"mi/pathological-string-1mb", bytes(pathologicalRecords), pathologicalRecords.size(),
+                          [pathologicalRecords]()
+    {
+        for(const QString& i : pathologicalRecords)
+        {
+            MiRecord::parse(i);
+        }
+    }});
+    QStringList pathologicalChunks = Generators::printChunks(pathological, 4096);
+    benchmarks.push_back({"print-capture/pathological-string-1mb", bytes(pathologicalChunks), 1, [pathologicalChunks]()
+    {
+        PrintCapture capture("text");
+        for(const QString& i : pathologicalChunks)
+        {
+            capture.append(i);
+        }
+        capture.finish(true);
+    }});
+    return benchmarks;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication application(argc, argv);
+    QStringList arguments = application.arguments();
+    QString filter;
+    QString baselineFile;
+    bool save = false;
+    for(int i = 1; i < arguments.size(); ++i)
+    {
+        if(arguments[i] == "--filter" && i+1 < arguments.size())
+        {
+            filter = arguments[++i];
+        }
+        else if(arguments[i] == "--baseline" && i+1 < arguments.size())
+        {
+            baselineFile = arguments[++i];
+        }
+        else if(arguments[i] == "--save")
+        {
+            save = true;
+        }
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--filter TEXT] [--baseline FILE] [--save]\n", argv[0]);
+            return 2;
+        }
+    }
+    if(save && baselineFile.isEmpty())
+    {
+        std::fprintf(stderr, "--save needs --baseline FILE\n");
+        return 2;
+    }
+
+    std::map<QString, Result> baseline = readBaseline(baselineFile);
+    std::vector<std::pair<QString, Result>> results;
+    std::printf("%-40s %14s %12s %10s %10s %10s\n", "benchmark", "ns/op", "allocs/op", "MB/s", "time", "allocs");
+    for(const Benchmark& i : createBenchmarks())
+    {
+        if(!filter.isEmpty() && !i.name.contains(filter))
+        {
+            continue;
+        }
+        Result result = measure(i);
+        results.emplace_back(i.name, result);
+        QString timeChange("-");
+        QString allocationsChange("-");
+        auto stored = baseline.find(i.name);
+        if(stored != baseline.end() && stored->second.nsPerOperation > 0)
+        {   // positive numbers are slowdowns
+            timeChange = QString("%1%").arg((result.nsPerOperation / stored->second.nsPerOperation - 1) * 100, 0, 'f', 1);
+            allocationsChange = QString::number(result.allocationsPerOperation - stored->second.allocationsPerOperation, 'f', 1);
+        }
+        std::printf("%-40s %14.1f %12.1f %10.1f %10s %10s\n", qPrintable(i.name), result.nsPerOperation,
+                    result.allocationsPerOperation, result.megabytesPerSecond,
+                    qPrintable(timeChange), qPrintable(allocationsChange));
+        std::fflush(stdout);
+    }
+    if(save && !saveBaseline(baselineFile, results))
+    {
+        std::fprintf(stderr, "Can't write %s\n", qPrintable(baselineFile));
+        return 1;
+    }
+    return 0;
+}
@@ -16,17 +16,24 @@ void Breakpoint::parse(const QString &line)
           throw std::exception("Format exception");
       }
       QRegExp disposition(" keep ");
+      QRegExp disable(" dis ");
       QRegExp enabled(" y ");
       QRegExp frame("\\s[:\\w]*\\([\\w\\s:,]*\\)\\s"); // find string between whitespaces
                                                        // contains from characters, ':', whitespaces and breackets
       QRegExp lineRegex(":\\d+");
-      if(disposition.indexIn(line) == -1)
+      QRegExp number("^\"?(\\d+)\\s");
+      mNumber = number.indexIn(line) == -1 ? 0 : number.cap(1).toInt();
+      if(disposition.indexIn(line) != -1)
       {
-          mDisposition = Disposition::Delete;
+          mDisposition = Disposition::Keep;
+      }
+      else if(disable.indexIn(line) != -1)
+      {
+          mDisposition = Disposition::Disable;
       }
       else
       {
-          mDisposition = Disposition::Keep;
+          mDisposition = Disposition::Delete;
       }
       mEnabled = enabled.indexIn(line) == -1 ? false : true;
       lineRegex.indexIn(line);
@@ -36,16 +43,74 @@ void Breakpoint::parse(const QString &line)
       mWhat = frame.cap().trimmed();
 }
 
-Breakpoint::Breakpoint()
+void Breakpoint::parse(const MiValue &bkpt)
+{   // fill breakpoint from MI breakpoint tuple. Hit limit is known only to us so it is kept
+    /*
+        bkpt={number="2",type="breakpoint",disp="keep",enabled="y",addr="0x0040149e",func="main()",
+              file="main.cpp",line="40",cond="i == 1000",times="0",ignore="5",thread="1",
+              original-location="main.cpp:40",thread-groups=["i1"]}
+    */
+    mNumber = bkpt["number"].getString().toInt();
+    mLine = bkpt["line"].getString().toInt();
+    mWhat = bkpt["func"].getString();
+    mLocation = bkpt["original-location"].getString();
+    QString type = bkpt["type"].getString();
+    mWatchKind = !type.endsWith("watchpoint") ? NoWatch : type.startsWith("read") ? WatchRead
+                                                        : type.startsWith("acc") ? WatchAccess : WatchWrite;
+    if(mWatchKind != NoWatch)
+    {   // watchpoint has expression instead of location
+        mLocation = bkpt["what"].getString();
+    }
+    else if(mLocation.isEmpty())
+    {
+        mLocation = QString("%1:%2").arg(bkpt["file"].getString()).arg(mLine);
+    }
+    mFile = bkpt.contains("fullname") ? bkpt["fullname"].getString() : bkpt["file"].getString();
+    mEnabled = bkpt["enabled"].getString() == "y";
+    QString disposition = bkpt["disp"].getString();
+    mDisposition = disposition == "keep" ? Disposition::Keep : disposition == "dis" ? Disposition::Disable : Disposition::Delete;
+    mCondition = bkpt["cond"].getString();
+    mIgnoreCount = bkpt["ignore"].getString().toInt();
+    mThread = bkpt.contains("thread") ? bkpt["thread"].getString().toInt() : -1;
+    mHitCount = bkpt["times"].getString().toInt();
+    mThreadGroups.clear();
+    const MiValue& groups = bkpt["thread-groups"];
+    for(int i=0;i<groups.size();++i)
+    {
+        mThreadGroups << groups.at(i).getString();
+    }
+}
+
+Breakpoint::Breakpoint():
+    mNumber{0},
+    mLine{0},
+    mEnabled{false},
+    mDisposition{Keep},
+    mIgnoreCount{0},
+    mThread{-1},
+    mHitCount{0},
+    mHitLimit{0},
+    mWatchKind{NoWatch}
 {
 }
 
 Breakpoint::Breakpoint(int line, QString what, bool enabled, Breakpoint::Disposition disposition):
+    mNumber(0),
     mLine(line),
     mWhat(what),
     mEnabled(enabled),
-    mDisposition(disposition)
+    mDisposition(disposition),
+    mIgnoreCount(0),
+    mThread(-1),
+    mHitCount(0),
+    mHitLimit(0),
+    mWatchKind(NoWatch)
+{
+}
+
+int Breakpoint::getNumber() const
 {
+    return mNumber;
 }
 
 int Breakpoint::getLine() const
@@ -58,12 +123,67 @@ QString Breakpoint::getFrame() const
     return mWhat;
 }
 
+QString Breakpoint::getLocation() const
+{
+    return mLocation;
+}
+
+QString Breakpoint::getFile() const
+{
+    return mFile;
+}
+
 bool Breakpoint::isEnabled() const
 {
     return mEnabled;
 }
 
+void Breakpoint::setEnabled(bool enabled)
+{
+    mEnabled = enabled;
+}
+
 Breakpoint::Disposition Breakpoint::getDisposition() const
 {
     return mDisposition;
 }
+
+QString Breakpoint::getCondition() const
+{
+    return mCondition;
+}
+
+int Breakpoint::getIgnoreCount() const
+{   // number of hits GDB will skip before stopping
+    return mIgnoreCount;
+}
+
+int Breakpoint::getThread() const
+{
+    return mThread;
+}
+
+int Breakpoint::getHitCount() const
+{
+    return mHitCount;
+}
+
+int Breakpoint::getHitLimit() const
+{
+    return mHitLimit;
+}
+
+void Breakpoint::setHitLimit(int limit)
+{
+    mHitLimit = limit;
+}
+
+Breakpoint::WatchKind Breakpoint::getWatchKind() const
+{   // what access to watched expression stops target, NoWatch for code breakpoints
+    return mWatchKind;
+}
+
+const QStringList &Breakpoint::getThreadGroups() const
+{
+    return mThreadGroups;
+}
@@ -2,23 +2,51 @@
 #define BREAKPOINT_H
 
 #include <QString>
+#include <QStringList>
+
+#include "mirecord.h"
 
 class Breakpoint
 {
 public:
-    enum Disposition{Keep, Delete};
+    enum Disposition{Keep, Delete, Disable};
+    enum WatchKind{NoWatch, WatchWrite, WatchRead, WatchAccess};
     void parse(const QString& line);// todo;
+    void parse(const MiValue& bkpt);
     Breakpoint();
     Breakpoint(int line, QString what, bool enabled, Disposition disposition);
+    int getNumber()const;
     int getLine()const;
     QString getFrame()const;
+    QString getLocation()const;
+    QString getFile()const;
     bool isEnabled()const;
+    void setEnabled(bool enabled);
     Disposition getDisposition()const;
+    QString getCondition()const;
+    int getIgnoreCount()const;
+    int getThread()const;
+    int getHitCount()const;
+    int getHitLimit()const;
+    void setHitLimit(int limit);
+    WatchKind getWatchKind()const;
+    const QStringList& getThreadGroups()const;
 private:
+    int mNumber;
     int mLine;
     QString mWhat;
+    QString mLocation;
+    QString mFile;      // full name of source file if GDB reported it
     bool mEnabled;
     Disposition mDisposition;
+    QString mCondition;
+    int mIgnoreCount;
+    int mThread;    // -1 if breakpoint is not thread-specific
+    int mHitCount;
+    int mHitLimit;  // GDB disables breakpoint after this number of hits, 0 if there is no limit. GDB reports
+                    // only hits left, so the limit user set is kept here
+    WatchKind mWatchKind;
+    QStringList mThreadGroups;  // inferiors which have locations of breakpoint, "i1" and so on
 };
 
 #endif // BREAKPOINT_H
@@ -0,0 +1,96 @@
+#include "commandscheduler.h"
+
+#include <algorithm>
+#include <iterator>
+
+CommandScheduler::CommandScheduler(int maxInFlight):
+    mMaxInFlight{maxInFlight}
+{
+}
+
+void CommandScheduler::enqueue(const Command &command)
+{
+    mQueues[command.priority].push_back(command);
+}
+
+bool CommandScheduler::takeNext(Command &command)
+{   //take the most important command which may be written now. Interactive and execution commands
+    //don't wait for the limit, they are behind at most $mMaxInFlight$ refresh commands in GDB
+    for(int priority = Interactive; priority < PriorityCount; ++priority)
+    {
+        std::deque<Command>& queue = mQueues[priority];
+        if(queue.empty())
+        {
+            continue;
+        }
+        if(priority >= View && static_cast<int>(mInFlight.size()) >= mMaxInFlight)
+        {
+            return false;
+        }
+        command = queue.front();
+        queue.pop_front();
+        mInFlight.push_back(command.token);
+        return true;
+    }
+    return false;
+}
+
+void CommandScheduler::complete(int token)
+{   //result of $token$ came. Results come in order, so it is the first one unless output was lost
+    auto found = std::find(mInFlight.begin(), mInFlight.end(), token);
+    if(found != mInFlight.end())
+    {
+        mInFlight.erase(found);
+    }
+}
+
+std::vector<CommandScheduler::Command> CommandScheduler::cancel(const QString &group)
+{   //remove waiting commands of $group$ and return them. Written commands can't be taken back
+    std::vector<Command> cancelled;
+    if(group.isEmpty())
+    {
+        return cancelled;
+    }
+    for(std::deque<Command>& queue : mQueues)
+    {
+        auto kept = std::stable_partition(queue.begin(), queue.end(),
+                                          [&group](const Command& command){return command.group != group;});
+        std::move(kept, queue.end(), std::back_inserter(cancelled));
+        queue.erase(kept, queue.end());
+    }
+    return cancelled;
+}
+
+void CommandScheduler::clear()
+{   //GDB was restarted, nothing written before will be answered
+    mInFlight.clear();
+    for(std::deque<Command>& queue : mQueues)
+    {
+        queue.clear();
+    }
+}
+
+int CommandScheduler::getInFlight() const
+{
+    return static_cast<int>(mInFlight.size());
+}
+
+int CommandScheduler::getQueued() const
+{
+    int queued = 0;
+    for(const std::deque<Command>& queue : mQueues)
+    {
+        queued += static_cast<int>(queue.size());
+    }
+    return queued;
+}
+
+int CommandScheduler::getMaxInFlight() const
+{
+    return mMaxInFlight;
+}
+
+void CommandScheduler::setMaxInFlight(int maxInFlight)
+{
+    mMaxInFlight = std::max(1, maxInFlight);
+}
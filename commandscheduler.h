@@ -0,0 +1,40 @@
+#ifndef COMMANDSCHEDULER_H
+#define COMMANDSCHEDULER_H
+
+#include <QString>
+#include <QByteArray>
+
+#include <deque>
+#include <vector>
+
+class CommandScheduler
+{   // holds commands before they are written to GDB. GDB runs commands one by one in order they
+    // were written, so everything written is a queue nobody can overtake. Only a few refresh commands
+    // are let into it at once, the rest wait here ordered by priority and can still be dropped
+public:
+    enum Priority{Interactive, Execution, View, Background, PriorityCount};
+    struct Command
+    {
+        int token;
+        QByteArray data;
+        Priority priority;
+        QString group;      // commands of group are dropped together, empty for commands which are never dropped
+    };
+
+    explicit CommandScheduler(int maxInFlight = 4);
+    void enqueue(const Command& command);
+    bool takeNext(Command& command);
+    void complete(int token);
+    std::vector<Command> cancel(const QString& group);
+    void clear();
+    int getInFlight()const;
+    int getQueued()const;
+    int getMaxInFlight()const;
+    void setMaxInFlight(int maxInFlight);
+private:
+    int mMaxInFlight;
+    std::deque<int> mInFlight;  // tokens of written commands in order GDB answers them
+    std::deque<Command> mQueues[PriorityCount];
+};
+
+#endif // COMMANDSCHEDULER_H
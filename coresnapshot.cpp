@@ -0,0 +1,170 @@
+#include "coresnapshot.h"
+
+#include <QDebug>
+
+static const int maxFrames = 256; // per thread, deep recursion shouldn't stall capture
+
+CoreSnapshot::CoreSnapshot(Gdb *gdb, QObject *parent):
+    QObject(parent),
+    mGdb{gdb},
+    mPending{0}
+{
+}
+
+void CoreSnapshot::load(const QString &executable, const QString &coreFile)
+{   //open $coreFile$ of $executable$ and capture it
+    mClock.start();
+    emit signalProgress(tr("Loading %1").arg(coreFile));
+    mGdb->openCore(executable, coreFile, [this](const MiRecord& record)
+    {
+        if(record.getClass() != "done" && record.getClass() != "connected")
+        {
+            emit signalProgress(tr("Can't load core: %1").arg(record["msg"].getString()));
+            return;
+        }
+        capture();
+    });
+}
+
+void CoreSnapshot::capture()
+{   //take threads, then stacks of all threads, then variables of all frames. Commands of every stage
+    //are sent together without waiting for replies, so capture costs three round trips whatever
+    //the number of threads is
+    if(isCapturing())
+    {
+        return;
+    }
+    if(!mClock.isValid())
+    {
+        mClock.start();
+    }
+    mThreads.clear();
+    mPending = 1;
+    emit signalProgress(tr("Reading threads"));
+    mGdb->sendCommand("-thread-info", [this](const MiRecord& record)
+    {
+        if(record.getClass() == "done")
+        {
+            readThreads(record["threads"]);
+        }
+        finishCommand();
+    }, false, CommandScheduler::Background, Gdb::getStopGroup());
+}
+
+bool CoreSnapshot::isCapturing() const
+{
+    return mPending != 0;
+}
+
+const std::vector<SnapshotThread> &CoreSnapshot::getThreads() const
+{
+    return mThreads;
+}
+
+const SnapshotThread *CoreSnapshot::findThread(int id) const
+{
+    for(const SnapshotThread& i : mThreads)
+    {
+        if(i.id == id)
+        {
+            return &i;
+        }
+    }
+    return nullptr;
+}
+
+int CoreSnapshot::getMaxFrames()
+{
+    return maxFrames;
+}
+
+void CoreSnapshot::readThreads(const MiValue &threads)
+{
+    mThreads.resize(threads.size());
+    for(int i = 0; i < threads.size(); ++i)
+    {
+        const MiValue& thread = threads.at(i);
+        SnapshotThread& snapshot = mThreads[i];
+        snapshot.id = thread["id"].getString().toInt();
+        snapshot.targetId = thread["target-id"].getString();
+        snapshot.name = thread["name"].getString();
+    }
+    emit signalProgress(tr("Reading stacks of %1 threads").arg(mThreads.size()));
+    for(size_t i = 0; i < mThreads.size(); ++i)
+    {
+        ++mPending;
+        QString command = QString("-stack-list-frames --thread %1 0 %2").arg(mThreads[i].id).arg(maxFrames-1);
+        mGdb->sendCommand(command, [this, i](const MiRecord& record)
+        {
+            if(record.getClass() == "done")
+            {
+                readFrames(i, record["stack"]);
+            }
+            finishCommand();
+        }, false, CommandScheduler::Background, Gdb::getStopGroup());
+    }
+}
+
+void CoreSnapshot::readFrames(size_t thread, const MiValue &stack)
+{
+    SnapshotThread& snapshot = mThreads[thread];
+    snapshot.frames.resize(stack.size());
+    for(int i = 0; i < stack.size(); ++i)
+    {
+        const MiValue& frame = stack.at(i);
+        SnapshotFrame& frameSnapshot = snapshot.frames[i];
+        frameSnapshot.level = frame["level"].getString().toInt();
+        frameSnapshot.address = frame["addr"].getString().toULongLong(nullptr, 16);
+        frameSnapshot.function = frame["func"].getString();
+        frameSnapshot.file = frame.contains("fullname") ? frame["fullname"].getString() : frame["file"].getString();
+        frameSnapshot.line = frame["line"].getString().toInt();
+        if(frameSnapshot.file.isEmpty())
+        {   // no debug info, GDB has no variables for it
+            continue;
+        }
+        ++mPending;
+        QString command = QString("-stack-list-variables --thread %1 --frame %2 --simple-values")
+                .arg(snapshot.id).arg(frameSnapshot.level);
+        size_t index = static_cast<size_t>(i);
+        mGdb->sendCommand(command, [this, thread, index](const MiRecord& record)
+        {
+            if(record.getClass() == "done")
+            {
+                readVariables(thread, index, record["variables"]);
+            }
+            finishCommand();
+        }, false, CommandScheduler::Background, Gdb::getStopGroup());
+    }
+}
+
+void CoreSnapshot::readVariables(size_t thread, size_t frame, const MiValue &variables)
+{
+    std::vector<SnapshotVariable>& snapshot = mThreads[thread].frames[frame].variables;
+    snapshot.resize(variables.size());
+    for(int i = 0; i < variables.size(); ++i)
+    {
+        const MiValue& variable = variables.at(i);
+        snapshot[i].name = variable["name"].getString();
+        snapshot[i].type = variable["type"].getString();
+        snapshot[i].value = variable["value"].getString();
+        snapshot[i].argument = variable["arg"].getString() == "1";
+    }
+}
+
+void CoreSnapshot::finishCommand()
+{
+    if(--mPending != 0)
+    {
+        return;
+    }
+    qint64 elapsed = mClock.elapsed();
+    mClock.invalidate();
+    size_t frames = 0;
+    for(const SnapshotThread& i : mThreads)
+    {
+        frames += i.frames.size();
+    }
+    qDebug() << "Core snapshot of" << mThreads.size() << "threads and" << frames << "frames took" << elapsed << "ms";
+    emit signalProgress(tr("%1 threads, %2 frames captured in %3 ms").arg(mThreads.size()).arg(frames).arg(elapsed));
+    emit signalCaptured(elapsed);
+}
@@ -0,0 +1,66 @@
+#ifndef CORESNAPSHOT_H
+#define CORESNAPSHOT_H
+
+#include <QObject>
+#include <QString>
+#include <QElapsedTimer>
+
+#include <vector>
+
+#include "gdb.h"
+
+struct SnapshotVariable
+{
+    QString name;
+    QString type;
+    QString value;      // empty for structures and arrays, only simple values are captured
+    bool argument;
+};
+
+struct SnapshotFrame
+{
+    int level;
+    quint64 address;
+    QString function;
+    QString file;
+    int line;
+    std::vector<SnapshotVariable> variables;
+};
+
+struct SnapshotThread
+{
+    int id;
+    QString targetId;
+    QString name;
+    std::vector<SnapshotFrame> frames;
+};
+
+class CoreSnapshot : public QObject
+{   // threads, stacks and locals of a core file captured at once, so browsing never waits for GDB
+    Q_OBJECT
+public:
+    explicit CoreSnapshot(Gdb* gdb, QObject* parent = 0);
+    void load(const QString& executable, const QString& coreFile);
+    void capture();
+    bool isCapturing()const;
+    const std::vector<SnapshotThread>& getThreads()const;
+    const SnapshotThread* findThread(int id)const;
+    static int getMaxFrames();
+
+signals:
+    void signalProgress(const QString& message);
+    void signalCaptured(qint64 elapsed);
+
+private:
+    void readThreads(const MiValue& threads);
+    void readFrames(size_t thread, const MiValue& stack);
+    void readVariables(size_t thread, size_t frame, const MiValue& variables);
+    void finishCommand();
+
+    Gdb* mGdb;
+    std::vector<SnapshotThread> mThreads;
+    int mPending;       // commands of capture GDB didn't answer yet
+    QElapsedTimer mClock;
+};
+
+#endif // CORESNAPSHOT_H
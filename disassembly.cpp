@@ -0,0 +1,217 @@
+#include "disassembly.h"
+
+#include <algorithm>
+#include <iterator>
+
+static const size_t cacheLimit = 1000;  // functions kept in cache, least recently used are dropped
+static const int prefetchDepth = 4;     // callers disassembled in background when a new function is entered
+static const int fallbackRange = 128;   // bytes disassembled when GDB doesn't know function bounds
+
+Disassembly::Disassembly(Gdb *gdb, QObject *parent):
+    QObject(parent),
+    mGdb{gdb},
+    mSourceInterleaved{false}
+{
+    connect(mGdb, SIGNAL(signalStopped(MiRecord)), this, SLOT(slotStopped(MiRecord)), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalFocusChanged(MiRecord)), this, SLOT(slotStopped(MiRecord)), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalInferiorStarted()), this, SLOT(slotInferiorStarted()), Qt::UniqueConnection);
+}
+
+const DisassembledFunction *Disassembly::find(quint64 address)
+{   // returns cached function containing $address$ or nullptr
+    auto found = mFunctions.upper_bound(address);
+    if(found == mFunctions.begin())
+    {
+        return nullptr;
+    }
+    --found;
+    if(address >= found->second.end)
+    {
+        return nullptr;
+    }
+    mUsage.splice(mUsage.begin(), mUsage, found->second.use);
+    return &found->second;
+}
+
+void Disassembly::show(quint64 address)
+{   // emits signalDisassembled when function with $address$ is in cache, asks GDB only on miss
+    if(find(address) != nullptr)
+    {
+        emit signalDisassembled(address);
+        return;
+    }
+    request(address, true);
+    prefetchCallers();
+}
+
+void Disassembly::prefetchCallers()
+{   // disassemble callers of current frame, stepping out of function will find them in cache
+    /*
+        ^done,stack=[frame={level="1",addr="0x00401590",func="main",file="main.cpp",line="40"}]
+    */
+    mGdb->sendCommand(QString("-stack-list-frames 1 %1").arg(prefetchDepth), [this](const MiRecord& record)
+    {
+        const MiValue& stack = record["stack"];
+        for(int i=0;i<stack.size();++i)
+        {
+            quint64 address = stack.at(i)["addr"].getString().toULongLong(nullptr, 0);
+            if(address != 0 && find(address) == nullptr)
+            {
+                request(address, false);
+            }
+        }
+    }, true, CommandScheduler::Background, Gdb::getStopGroup());
+}
+
+void Disassembly::setSourceInterleaved(bool interleaved)
+{
+    if(mSourceInterleaved != interleaved)
+    {
+        mSourceInterleaved = interleaved;
+        clear();
+    }
+}
+
+bool Disassembly::isSourceInterleaved() const
+{
+    return mSourceInterleaved;
+}
+
+void Disassembly::clear()
+{
+    mFunctions.clear();
+    mUsage.clear();
+}
+
+void Disassembly::slotStopped(const MiRecord &record)
+{
+    quint64 address = record["frame"]["addr"].getString().toULongLong(nullptr, 0);
+    if(address != 0)
+    {
+        show(address);
+    }
+}
+
+void Disassembly::slotInferiorStarted()
+{   // code may be loaded at other addresses in new process
+    clear();
+}
+
+void Disassembly::request(quint64 address, bool show)
+{   // disassemble whole function containing $address$. If it is already requested in background,
+    // the running request shows it when done
+    auto requested = mRequested.find(address);
+    if(requested != mRequested.end())
+    {
+        requested->second = requested->second || show;
+        return;
+    }
+    mRequested[address] = show;
+    int mode = mSourceInterleaved ? 4 : 0;
+    QString command = QString("-data-disassemble -a 0x%1 -- %2").arg(address, 0, 16).arg(mode);
+    CommandScheduler::Priority priority = show ? CommandScheduler::View : CommandScheduler::Background;
+    mGdb->sendCommand(command, [this, address, mode](const MiRecord& record)
+    {
+        bool show = mRequested[address];
+        mRequested.erase(address);
+        if(mode != (mSourceInterleaved ? 4 : 0) || Gdb::isCancelled(record))
+        {
+            return; // mode was changed while GDB disassembled or target resumed before request was sent
+        }
+        if(record.getClass() == "done")
+        {
+            store(record["asm_insns"]);
+            if(show && find(address) != nullptr)
+            {
+                emit signalDisassembled(address);
+            }
+            return;
+        }
+        if(show)
+        {   // no function bounds (no symbols), disassemble fixed range after address
+            QString range = QString("-data-disassemble -s 0x%1 -e 0x%2 -- 0")
+                    .arg(address, 0, 16).arg(address + fallbackRange, 0, 16);
+            mGdb->sendCommand(range, [this, address](const MiRecord& record)
+            {
+                if(record.getClass() == "done")
+                {
+                    store(record["asm_insns"]);
+                    if(find(address) != nullptr)
+                    {
+                        emit signalDisassembled(address);
+                    }
+                }
+            }, true, CommandScheduler::View, Gdb::getStopGroup());
+        }
+    }, true, priority, Gdb::getStopGroup());
+}
+
+void Disassembly::store(const MiValue &instructions)
+{   // put disassembled function to cache
+    /*
+        asm_insns=[{address="0x00401516",func-name="main",offset="4",inst="mov    %eax,-0x4(%rbp)"}]
+        asm_insns=[src_and_asm_line={line="31",file="main.cpp",fullname="/src/main.cpp",
+                                     line_asm_insn=[{address="0x00401516",func-name="main",offset="4",inst="..."}]}]
+    */
+    DisassembledFunction function{0, 0, QString(), std::vector<DisassemblyLine>(), mUsage.end()};
+    auto addInstruction = [&](const MiValue& instruction)
+    {
+        quint64 address = instruction["address"].getString().toULongLong(nullptr, 0);
+        if(function.lines.empty() || function.name.isEmpty())
+        {
+            function.name = instruction["func-name"].getString();
+        }
+        if(function.start == 0 || address < function.start)
+        {
+            function.start = address;
+        }
+        function.end = std::max(function.end, address+1);
+        function.lines.push_back(DisassemblyLine{address, QString("0x%1 <+%2>\t%3").arg(address, 0, 16)
+                                                 .arg(instruction["offset"].getString())
+                                                 .arg(instruction["inst"].getString())});
+    };
+    for(int i=0;i<instructions.size();++i)
+    {
+        const MiValue& item = instructions.at(i);
+        if(!item.contains("line_asm_insn"))
+        {
+            addInstruction(item);
+            continue;
+        }
+        function.lines.push_back(DisassemblyLine{0, QString("%1:%2").arg(item["file"].getString())
+                                                 .arg(item["line"].getString())});
+        const MiValue& lineInstructions = item["line_asm_insn"];
+        for(int j=0;j<lineInstructions.size();++j)
+        {
+            addInstruction(lineInstructions.at(j));
+        }
+    }
+    if(function.start == 0)
+    {
+        return;
+    }
+    /* drop cached ranges overlapping new one, e.g. fallback range inside the function */
+    auto overlap = mFunctions.lower_bound(function.start);
+    if(overlap != mFunctions.begin() && std::prev(overlap)->second.end > function.start)
+    {
+        --overlap;
+    }
+    while(overlap != mFunctions.end() && overlap->first < function.end)
+    {
+        erase(overlap++);
+    }
+    quint64 start = function.start;
+    mUsage.push_front(start);
+    function.use = mUsage.begin();
+    mFunctions[start] = std::move(function);
+    if(mFunctions.size() > cacheLimit)
+    {   // drop least recently used function
+        erase(mFunctions.find(mUsage.back()));
+    }
+}
+
+void Disassembly::erase(std::map<quint64, DisassembledFunction>::iterator function)
+{
+    mUsage.erase(function->second.use);
+    mFunctions.erase(function);
+}
@@ -0,0 +1,59 @@
+#ifndef DISASSEMBLY_H
+#define DISASSEMBLY_H
+
+#include <QObject>
+#include <QString>
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "gdb.h"
+
+struct DisassemblyLine
+{
+    quint64 address;    // 0 for source lines
+    QString text;
+};
+
+struct DisassembledFunction
+{
+    quint64 start;
+    quint64 end;        // address after the last instruction
+    QString name;
+    std::vector<DisassemblyLine> lines;
+    std::list<quint64>::iterator use;   // position in usage list
+};
+
+class Disassembly : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Disassembly(Gdb* gdb, QObject* parent = 0);
+    const DisassembledFunction* find(quint64 address);
+    void show(quint64 address);
+    void prefetchCallers();
+    void setSourceInterleaved(bool interleaved);
+    bool isSourceInterleaved()const;
+    void clear();
+
+public slots:
+    void slotStopped(const MiRecord& record);
+    void slotInferiorStarted();
+
+signals:
+    void signalDisassembled(quint64 address);
+
+private:
+    void request(quint64 address, bool show);
+    void store(const MiValue& instructions);
+    void erase(std::map<quint64, DisassembledFunction>::iterator function);
+
+    Gdb* mGdb;
+    std::map<quint64, DisassembledFunction> mFunctions;  // cache by function start address
+    std::list<quint64> mUsage;      // start addresses of cached functions, the most recently used first
+    std::map<quint64, bool> mRequested; // addresses GDB disassembles, true if result should be shown
+    bool mSourceInterleaved;
+};
+
+#endif // DISASSEMBLY_H
@@ -0,0 +1,198 @@
+#include "evaluator.h"
+
+#include <QStringList>
+
+static const int hoverDelay = 250;          // ms mouse has to rest on expression
+static const int maxHoversPerSecond = 4;
+static const int maxElements = 100;         // of arrays and containers
+static const int maxValueBytes = 64*1024;   // read from target for one value
+
+Evaluator::Evaluator(Gdb *gdb, QObject *parent):
+    QObject(parent),
+    mGdb{gdb},
+    mTimeBudget{500},
+    mMaxChars{4096},
+    mSent{0}
+{
+    mHoverTimer.setSingleShot(true);
+    mClock.start();
+    connect(&mHoverTimer, SIGNAL(timeout()), this, SLOT(slotHoverTimeout()), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalStopped(MiRecord)), this, SLOT(slotStopped()), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalFocusChanged(MiRecord)), this, SLOT(slotStopped()), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalRunning()), this, SLOT(slotRunning()), Qt::UniqueConnection);
+}
+
+void Evaluator::setBudget(int milliseconds, int maxChars)
+{   //evaluation waiting longer than $milliseconds$ is dropped if it isn't sent yet, or reported
+    //as truncated if GDB is already evaluating it. Values are cut to $maxChars$
+    mTimeBudget = milliseconds;
+    mMaxChars = maxChars;
+}
+
+void Evaluator::hover(const QString &expression)
+{   //evaluate $expression$ when mouse rests on it. Empty $expression$ cancels waiting hover
+    mHoverExpression = expression;
+    mHoverTimer.stop();
+    Result result;
+    if(expression.isEmpty())
+    {
+        return;
+    }
+    if(find(expression, result))
+    {
+        emit signalEvaluated(expression, result);
+        return;
+    }
+    mHoverTimer.start(hoverDelay);
+}
+
+void Evaluator::evaluate(const QString &expression)
+{   //evaluate $expression$ at once, e.g. typed by user
+    Result result;
+    if(find(expression, result))
+    {
+        emit signalEvaluated(expression, result);
+        return;
+    }
+    send(expression, CommandScheduler::Interactive);
+}
+
+bool Evaluator::find(const QString &expression, Evaluator::Result &result) const
+{
+    auto found = mCache.find(expression);
+    if(found == mCache.end())
+    {
+        return false;
+    }
+    result = found.value();
+    return true;
+}
+
+int Evaluator::getSent() const
+{   //number of queries sent to GDB
+    return mSent;
+}
+
+void Evaluator::slotStopped()
+{   // values of the previous stop are stale, e.g. after rewind GDB stops without running
+    clear();
+}
+
+void Evaluator::slotRunning()
+{
+    clear();
+}
+
+void Evaluator::slotHoverTimeout()
+{
+    if(mHoverExpression.isEmpty())
+    {
+        return;
+    }
+    qint64 now = mClock.elapsed();
+    while(!mHoverSends.empty() && now - mHoverSends.front() >= 1000)
+    {
+        mHoverSends.pop_front();
+    }
+    if(static_cast<int>(mHoverSends.size()) >= maxHoversPerSecond)
+    {   // wait until the oldest query is a second old. Mouse may move on meanwhile
+        mHoverTimer.start(static_cast<int>(1000 - (now - mHoverSends.front())));
+        return;
+    }
+    if(mPending.contains(mHoverExpression))
+    {
+        return;
+    }
+    mHoverSends.push_back(now);
+    send(mHoverExpression, CommandScheduler::View);
+}
+
+void Evaluator::slotCheckBudget()
+{   // queued evaluations over budget are dropped, their handlers report it. Evaluations GDB
+    // is busy with can't be interrupted, they are reported as truncated and finish later
+    QStringList overdue;
+    for(auto i = mPending.begin(); i != mPending.end(); ++i)
+    {
+        if(!i.value().reported && i.value().clock.elapsed() >= mTimeBudget)
+        {
+            overdue << i.key();
+        }
+    }
+    for(const QString& i : overdue)
+    {
+        if(mGdb->cancelCommands(getGroup(i)) != 0)
+        {
+            continue;
+        }
+        auto pending = mPending.find(i);
+        if(pending != mPending.end())
+        {
+            pending.value().reported = true;
+            Result result;
+            result.value = tr("<evaluating for more than %1 ms>").arg(mTimeBudget);
+            result.truncated = true;
+            emit signalEvaluated(i, result);
+        }
+    }
+}
+
+void Evaluator::send(const QString &expression, CommandScheduler::Priority priority)
+{   //query GDB unless the same expression is being evaluated, its reply serves both requests
+    if(mPending.contains(expression))
+    {
+        return;
+    }
+    Pending& pending = mPending[expression];
+    pending.clock.start();
+    pending.reported = false;
+    ++mSent;
+    QString command = QString("uidebugger-eval chars=%1 elements=%2 bytes=%3 %4").arg(mMaxChars)
+            .arg(maxElements).arg(maxValueBytes).arg(expression);
+    mGdb->sendCommand(command, [this, expression](const MiRecord& record)
+    {
+        /*
+            eval|0|int|42
+        */
+        QString output = mGdb->getHelperOutput().trimmed();
+        if(!mPending.remove(expression))
+        {
+            return; // target ran meanwhile, the result belongs to the old stop
+        }
+        Result result;
+        if(record.getClass() == "done" && output.startsWith("eval|"))
+        {
+            QStringList fields = output.split('|');
+            result.truncated = fields.value(1) == "1";
+            result.type = MiRecord::unescapeHelper(fields.value(2));
+            result.value = MiRecord::unescapeHelper(fields.mid(3).join('|'));
+        }
+        else
+        {
+            result.error = true;
+            result.value = Gdb::isCancelled(record) ? tr("<not evaluated within %1 ms>").arg(mTimeBudget)
+                                                    : record["msg"].getString();
+        }
+        if(!Gdb::isCancelled(record))
+        {
+            mCache.insert(expression, result);
+        }
+        emit signalEvaluated(expression, result);
+    }, false, priority, getGroup(expression));
+    QTimer::singleShot(mTimeBudget, this, SLOT(slotCheckBudget()));
+}
+
+void Evaluator::clear()
+{   // written queries still get replies, they are ignored as their expressions aren't pending
+    QStringList pending = mPending.keys();
+    mPending.clear();
+    mCache.clear();
+    for(const QString& i : pending)
+    {
+        mGdb->cancelCommands(getGroup(i));
+    }
+}
+
+QString Evaluator::getGroup(const QString &expression)
+{
+    return "eval:" + expression;
+}
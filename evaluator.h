@@ -0,0 +1,69 @@
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QTimer>
+#include <QElapsedTimer>
+
+#include <deque>
+
+#include "gdb.h"
+
+class Evaluator : public QObject
+{   // values of expressions user points at. Results are cached until target runs, requests for
+    // expression already being evaluated wait for the same reply, and hover requests are debounced
+    // and limited per second, so sweeping mouse over code doesn't queue a command per word
+    Q_OBJECT
+public:
+    struct Result
+    {
+        QString type;
+        QString value;          // error message if error is set
+        bool truncated = false; // value is cut by size budget or still being evaluated after time budget
+        bool error = false;
+    };
+
+    explicit Evaluator(Gdb* gdb, QObject* parent = 0);
+    void setBudget(int milliseconds, int maxChars);
+    void hover(const QString& expression);
+    void evaluate(const QString& expression);
+    bool find(const QString& expression, Result& result)const;
+    int getSent()const;
+
+public slots:
+    void slotStopped();
+    void slotRunning();
+
+signals:
+    void signalEvaluated(const QString& expression, const Evaluator::Result& result);
+
+private slots:
+    void slotHoverTimeout();
+    void slotCheckBudget();
+
+private:
+    struct Pending
+    {
+        QElapsedTimer clock;
+        bool reported;      // late result was reported as truncated already
+    };
+
+    void send(const QString& expression, CommandScheduler::Priority priority);
+    void clear();
+    static QString getGroup(const QString& expression);
+
+    Gdb* mGdb;
+    int mTimeBudget;
+    int mMaxChars;
+    QHash<QString, Result> mCache;      // results of the current stop
+    QHash<QString, Pending> mPending;   // expressions sent to GDB and not answered yet
+    QString mHoverExpression;
+    QTimer mHoverTimer;
+    QElapsedTimer mClock;
+    std::deque<qint64> mHoverSends;     // times of the last hover queries, for rate limit
+    int mSent;
+};
+
+#endif // EVALUATOR_H
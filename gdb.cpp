@@ -3,15 +3,46 @@
 #include <QDebug>
 #include <iostream>
 #include <QRegExp>
+#include <QDir>
 
-Gdb::Gdb()
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#endif
+
+static const char logpointMarker[] = "@lp"; // prefix of dprintf output, followed by logpoint id and '|'
+static const char helperBegin[] = "@uidbg-begin\n"; // helper commands frame their output with these lines
+static const char helperEnd[] = "@uidbg-end\n";
+static const char printMarker[] = "@uidbg-print\n";   // uidebugger-print writes it right before its output
+static const char cancelledMessage[] = "Cancelled before sending to GDB"; // msg of result passed to handlers of dropped commands
+
+Gdb::Gdb():
+    mNextToken{1},
+    mSessionLog{nullptr},
+    mNextLogpointId{1},
+    mHelperCapture{false},
+    mPrintReported{0},
+    mPrintArmed{false},
+    mStopSettling{false},
+    mStopCommands{0},
+    mFollowStops{false}
 {
 }
 
 Gdb::Gdb(QString gdbPath):
     mInfoCaptured{false},
     mWhatisCaptured{false},
-    mPrintCaptured{false}
+    mNextToken{1},
+    mSessionLog{nullptr},
+    mNextLogpointId{1},
+    mHelperCapture{false},
+    mPrintReported{0},
+    mPrintArmed{false},
+    mStopSettling{false},
+    mStopCommands{0},
+    mFollowStops{false}
 {
     mGdbFile.setFileName(gdbPath);
     connect(this, SIGNAL(readyReadStandardOutput()), this, SLOT(slotReadStdOutput()), Qt::UniqueConnection);
@@ -25,7 +56,10 @@ void Gdb::start(const QStringList &arguments, QIODevice::OpenMode mode)
         QString message = tr("Gdb not found at %1").arg(mGdbFile.fileName());
         throw std::exception(message.toStdString().c_str());
     }
+    mScheduler.clear();
     QProcess::start(mGdbFile.fileName(), arguments, mode);
+    sendCommand("-enable-pretty-printing"); // variable objects use Python pretty-printers for STL containers
+    loadHelpers();
 }
 
 void Gdb::write(QByteArray &command)
@@ -39,14 +73,157 @@ void Gdb::write(QByteArray &command)
     }
 }
 
+int Gdb::sendCommand(const QString &command, ResultHandler handler, bool echo,
+                     CommandScheduler::Priority priority, const QString &group)
+{   //writes MI command prefixed with unique token. $handler$ is called with result record of this command.
+    //Result isn't shown in echo if $echo$ is false, use it for commands with huge replies.
+    //Command waits in scheduler by its $priority$ and may be dropped with its $group$ before it is written,
+    //commands of stop group are dropped when target resumes
+    if(priority == CommandScheduler::Execution)
+    {
+        cancelCommands(getStopGroup());
+    }
+    int token = mNextToken++;
+    if(handler)
+    {
+        mPendingCommands[token] = handler;
+    }
+    if(!echo)
+    {
+        mSilentCommands.insert(token);
+    }
+    mScheduler.enqueue(CommandScheduler::Command{token, QByteArray::number(token).append(command.toUtf8()),
+                                                 priority, group});
+    writeScheduled();
+    return token;
+}
+
+int Gdb::cancelCommands(const QString &group)
+{   //drop commands of $group$ which aren't written yet. Their handlers get error result, so callers
+    //waiting for replies can tell it by isCancelled. Returns number of dropped commands
+    std::vector<CommandScheduler::Command> cancelled = mScheduler.cancel(group);
+    for(const CommandScheduler::Command& i : cancelled)
+    {
+        mSilentCommands.erase(i.token);
+        auto handler = mPendingCommands.find(i.token);
+        if(handler == mPendingCommands.end())
+        {
+            continue;
+        }
+        ResultHandler callback = handler->second;
+        mPendingCommands.erase(handler);
+        callback(MiRecord::parse(QString("%1^error,msg=%2").arg(i.token).arg(MiRecord::quote(cancelledMessage))));
+    }
+    return static_cast<int>(cancelled.size());
+}
+
+CommandScheduler &Gdb::getScheduler()
+{
+    return mScheduler;
+}
+
+bool Gdb::isCancelled(const MiRecord &record)
+{
+    return record.getClass() == "error" && record["msg"].getString() == cancelledMessage;
+}
+
+const QString &Gdb::getStopGroup()
+{   //commands reading state of the current stop, they are useless once target runs
+    static const QString stopGroup("stop");
+    return stopGroup;
+}
+
+void Gdb::writeScheduled()
+{
+    CommandScheduler::Command command;
+    while(mScheduler.takeNext(command))
+    {
+        if(mSessionLog != nullptr)
+        {
+            mSessionLog->append(SessionLog::Command, QString::fromUtf8(command.data), command.token);
+        }
+        write(command.data);
+    }
+}
+
+bool Gdb::routeStop(const MiRecord &stopped)
+{   //update inferior of $stopped$. Returns false if views shouldn't be refreshed: the stop is in other
+    //inferior than focused one, which is stopped and user looks at it. Its stop is kept to be shown
+    //when inferior gets focus and is reported by signalBackgroundStopped while GDB still has thread
+    //of the stop selected, then GDB is switched back to focused thread
+    const Inferiors::Inferior* focused = mInferiors.find(mInferiors.getFocus());
+    bool focusedStopped = focused != nullptr && focused->state == Inferiors::Stopped;
+    if(mInferiors.read(stopped))
+    {
+        emit signalInferiorsChanged();
+    }
+    int number = mInferiors.findByThread(stopped["thread-id"].getString().toInt());
+    if(number == 0 || number == mInferiors.getFocus())
+    {
+        return true;
+    }
+    if(!focusedStopped || mFollowStops)
+    {
+        setFocus(number);
+        emit signalInferiorsChanged();
+        return true;
+    }
+    emit signalBackgroundStopped(stopped);
+    if(focused->currentThread != 0)
+    {
+        sendCommand(QString("-thread-select %1").arg(focused->currentThread), ResultHandler(), false);
+    }
+    return false;
+}
+
+void Gdb::checkStopSettled()
+{   //stop is settled when every command views sent for it is answered. Time it took is what user
+    //waits for after each step, over remote protocol it shows how many round trips refreshes cost
+    if(mStopSettling && mScheduler.getInFlight() == 0 && mScheduler.getQueued() == 0)
+    {
+        mStopSettling = false;
+        emit signalStopSettled(mStopClock.elapsed(), mStopCommands);
+    }
+}
+
+void Gdb::setSessionLog(SessionLog *log)
+{   //every command and MI record is appended to $log$
+    mSessionLog = log;
+}
+
 void Gdb::readStdOutput()
 {   //Reads all standart output from GDB
-    mBuffer = QProcess::readAll();
+    /* Split output by complete MI records. Records consumed by handleRecord (logpoint hits and so on)
+       are not passed further, so they don't reach text parsing below and echo */
+    mLineSplitter.append(QProcess::readAll());
+    mBuffer.clear();
+    QString line;
+    while(mLineSplitter.next(line))
+    {
+        QString record = line;
+        while(record.endsWith('\n') || record.endsWith('\r'))
+        {
+            record.chop(1);
+        }
+        MiRecord parsed = MiRecord::parse(record);
+        if(mSessionLog != nullptr)
+        {
+            mSessionLog->append(parsed, record);
+        }
+        if(!handleRecord(parsed))
+        {
+            mBuffer.append(line);
+        }
+    }
+    if(mBuffer.isEmpty())
+    {
+        return;
+    }
+
     QRegExp errorMatch("\\^error"); // match '^error' literally
     QRegExp info("info\\s"); // match '^info ' literally
     QRegExp doneOrError("\\^done|\\^error"); // match '^done' or '^error' literally
     QRegExp whatis("whatis\\s"); // match 'whatis ' literally
-    QRegExp printRegex("print\\s"); // match 'print ' literally
     QRegExp breakpoint("\\*stopped,reason=\"breakpoint-hit\""); // match breakpoint stops
     QRegExp line("line=\"\\d+\""); // match line='$_digits_$'
 
@@ -60,19 +237,6 @@ void Gdb::readStdOutput()
         emit signalBreakpointHit(bareLine.toInt());
     }
 
-    /*print capturing section*/
-    if(printRegex.indexIn(mBuffer) != -1 || mPrintCaptured)
-    {
-        mPrintCaptured = true;
-        mPrintBuffer.append(mBuffer);
-    }
-    if(mPrintCaptured && doneOrError.indexIn(mBuffer) != -1)
-    {
-        readContent(mPrintBuffer);
-        mPrintCaptured = false;
-        mPrintBuffer.clear();
-    }
-
     /*whatis capturing section*/
     if(whatis.indexIn(mBuffer) != -1 || mWhatisCaptured)
     { // is 'whatis' appears in output
@@ -120,6 +284,204 @@ void Gdb::readStdOutput()
     emit signalReadyReadGdb();
 }
 
+bool Gdb::handleRecord(const MiRecord &record)
+{   //dispatch one MI record. Returns true if record is consumed and shouldn't be shown
+    switch(record.getType())
+    {
+    case MiRecord::ConsoleStream:
+        if(handlePrintOutput(record.getStream()) || handleHelperOutput(record.getStream())
+                || handleLogpointOutput(record.getStream()))
+        {
+            return true;
+        }
+        emit signalConsoleOutput(record.getStream());
+        return false;
+    case MiRecord::NotifyAsync:
+        if(mInferiors.read(record))
+        {
+            emit signalInferiorsChanged();
+        }
+        emit signalNotification(record);
+        if(record.getClass() == "breakpoint-created" || record.getClass() == "breakpoint-modified")
+        {   // dprintf reports its hit count on every hit, it is counted in hit log already.
+            // Ignored hits of conditional breakpoints are reported too, so only table is updated
+            int number = record["bkpt"]["number"].getString().toInt();
+            if(mLogpointByNumber.count(number) != 0)
+            {
+                return true;
+            }
+            updateBreakpoint(record["bkpt"]);
+            return record.getClass() == "breakpoint-modified";
+        }
+        if(record.getClass() == "thread-group-started")
+        {   // forked workers share code of focused process, its caches stay valid
+            if(Inferiors::parseId(record["id"].getString()) == mInferiors.getFocus())
+            {
+                emit signalInferiorStarted();
+            }
+            sendCommand("-list-thread-groups", [this](const MiRecord& record)
+            {
+                if(record.getClass() == "done")
+                {
+                    mInferiors.readGroups(record["groups"]);
+                    emit signalInferiorsChanged();
+                }
+            }, false, CommandScheduler::Background);
+        }
+        if(record.getClass() == "breakpoint-deleted")
+        {
+            int number = record["id"].getString().toInt();
+            auto found = std::find_if(mBreakpointsList.begin(), mBreakpointsList.end(),
+                                      [&](const Breakpoint& brk){return brk.getNumber() == number;});
+            if(found != mBreakpointsList.end())
+            {
+                mBreakpointsList.erase(found);
+                emit signalBreakpointsChanged();
+            }
+            mRecordingWatchpoints.erase(number);
+        }
+        return false;
+    case MiRecord::ExecAsync:
+        if(record.getClass() == "stopped")
+        {
+            if(mWatchHistory.readTrigger(record))
+            {
+                emit signalWatchHistoryChanged();
+            }
+            if(!routeStop(record))
+            {
+                return false;
+            }
+            mStopClock.start();
+            mStopSettling = true;
+            mStopCommands = 0;
+            readWatchHistory();
+            emit signalStopped(record);
+            checkStopSettled();
+        }
+        else if(record.getClass() == "running")
+        {   // target may be resumed by command user typed, refreshes of old stop aren't needed.
+            // Other inferior resuming doesn't make views of focused one stale
+            if(mInferiors.read(record))
+            {
+                emit signalInferiorsChanged();
+            }
+            int number = mInferiors.findByThread(record["thread-id"].getString().toInt());
+            if(number != 0 && number != mInferiors.getFocus())
+            {
+                return false;
+            }
+            cancelCommands(getStopGroup());
+            mStopSettling = false;
+            emit signalRunning();
+        }
+        return false;
+    case MiRecord::Result:
+    {
+        mScheduler.complete(record.getToken());
+        if(mStopSettling)
+        {
+            ++mStopCommands;
+        }
+        auto handler = mPendingCommands.find(record.getToken());
+        if(handler != mPendingCommands.end())
+        {
+            ResultHandler callback = handler->second;
+            mPendingCommands.erase(handler);
+            callback(record);
+        }
+        writeScheduled();
+        checkStopSettled();
+        return mSilentCommands.erase(record.getToken()) != 0;
+    }
+    default:
+        return false;
+    }
+}
+
+void Gdb::updateBreakpoint(const MiValue &bkpt)
+{   //create or update breakpoint from MI tuple
+    int number = bkpt["number"].getString().toInt();
+    if(number == 0)
+    {
+        return;
+    }
+    auto found = std::find_if(mBreakpointsList.begin(), mBreakpointsList.end(),
+                              [&](const Breakpoint& brk){return brk.getNumber() == number;});
+    if(found == mBreakpointsList.end())
+    {
+        mBreakpointsList.emplace_back();
+        found = mBreakpointsList.end()-1;
+    }
+    found->parse(bkpt);
+    emit signalBreakpointsChanged();
+}
+
+void Gdb::readBreakpoint(int number)
+{   //update breakpoint $number$ from GDB. It doesn't notify about changes made by MI commands
+    sendCommand(QString("-break-info %1").arg(number), [this](const MiRecord& record)
+    {
+        const MiValue& body = record["BreakpointTable"]["body"];
+        if(record.getClass() == "done" && body.size() > 0)
+        {
+            updateBreakpoint(body.at(0));
+        }
+    });
+}
+
+bool Gdb::handleHelperOutput(const QString &stream)
+{   //collect output of helper command framed by begin and end lines. It is read by result handler
+    if(!mHelperCapture)
+    {
+        if(!stream.startsWith(helperBegin))
+        {
+            return false;
+        }
+        mHelperCapture = true;
+        mHelperOutput = stream.mid(sizeof(helperBegin)-1);
+    }
+    else
+    {
+        mHelperOutput.append(stream);
+    }
+    if(mHelperOutput.endsWith(helperEnd))
+    {
+        mHelperOutput.chop(sizeof(helperEnd)-1);
+        mHelperCapture = false;
+    }
+    return true;
+}
+
+bool Gdb::handleLogpointOutput(const QString &stream)
+{   //append logpoint hit to hit log if $stream$ is dprintf output
+    /*
+        ~"@lp3|i = 1000\n"
+    */
+    if(!stream.startsWith(logpointMarker))
+    {
+        return false;
+    }
+    int separator = stream.indexOf('|');
+    if(separator == -1)
+    {
+        return false;
+    }
+    const int markerLength = sizeof(logpointMarker)-1;
+    bool isNumber = false;
+    int id = stream.mid(markerLength, separator-markerLength).toInt(&isNumber);
+    if(!isNumber || mLogpoints.count(id) == 0)
+    {
+        return false;
+    }
+    QString message = stream.mid(separator+1);
+    if(message.endsWith('\n'))
+    {
+        message.chop(1);
+    }
+    mHitLog.append(id, message);
+    return true;
+}
+
 void Gdb::readType(const QString &varName)
 {
     QRegExp findType("type\\s\\=\\s[\\w:\\*\\s\\<\\>\\,]+"); // find string after 'type = ' included only characters,
@@ -136,7 +498,7 @@ void Gdb::readType(const QString &varName)
             QString bareType = type.split('=')[1].trimmed(); // type is string after 'type = '
             QString nameStr = findName.cap();
             QString bareName = nameStr.split(' ')[1].trimmed();
-            auto var = find_if(mVariableTypeQueue.begin(), mVariableTypeQueue.end(), [&](Variable var){return var.getName() == bareName;});
+            auto var = find_if(mVariableTypeQueue.begin(), mVariableTypeQueue.end(), [&](const Variable& var){return var.getName() == bareName;});
             var->setType(bareType);
             emit signalTypeUpdated(*var);
             mVariableTypeQueue.erase(var);
@@ -145,33 +507,6 @@ void Gdb::readType(const QString &varName)
     while(pos != -1);
 }
 
-void Gdb::readContent(const QString &context)
-{
-    QRegExp findName("print\\s[\\w.*)(]+");
-    QRegExp content("=.*\\^done"); // match string beginning with '= ' and ending with '^done'
-    QRegExp clean("[\\\\\"|~]"); // find all garbage characters '\', '"', '~'
-
-    findName.indexIn(context);
-    QString badName = findName.cap();
-    QString bareName = badName.split(' ')[1].trimmed();
-
-    content.indexIn(context);
-    QString bareRes = content.cap();
-    QString firstMatches = bareRes.split(QString("^done")).first();
-    QString res = firstMatches.replace(clean, "").replace("^done", "").trimmed();
-    res.resize(res.size()-1); // last character is garbate too
-
-    /* Removed all line breaks */
-    auto lst = res.split('\n');
-    for(QString& i : lst)
-    {
-      i = i.trimmed();
-    }
-    QString withoutLines = lst.join(""); // complete one QString again
-    withoutLines.remove(0, 2); // first two charactes are garbage too '= '
-    emit signalContentUpdated(Variable(bareName, "", withoutLines));
-}
-
 QString Gdb::getVarContentFromContext(const QString &context)
 {   // Produces variable value by GDB output
     QRegExp content("=\\s.*\\^done"); // match string beginning with '= ' and ending with '^done'
@@ -200,6 +535,9 @@ void Gdb::updateVariableFromBuffer()
 {   // Read variables from mBuffer with their content
     QRegExp clean("~|\"|\\s|=");// find all garbage character
 
+    /* contents of all variables are kept in one buffer, variables and their fields are ranges of it */
+    std::vector<std::pair<QString, int>> names;
+    QString buffer;
     QStringList vars = mBuffer.split("\\n");
     for(auto i : vars)
     {
@@ -218,14 +556,25 @@ void Gdb::updateVariableFromBuffer()
         QString content = getVarContentFromContext(value);
         if(!content.isEmpty())
         {
-            mVariablesList.emplace_back(splittedBuffer[0].replace(clean, ""), "", content);
+            names.emplace_back(splittedBuffer[0].replace(clean, ""), buffer.size());
+            buffer.append(content);
         }
     }
+    std::shared_ptr<const QString> shared = std::make_shared<const QString>(buffer);
+    for(size_t i = 0; i < names.size(); ++i)
+    {
+        int end = i+1 < names.size() ? names[i+1].second : buffer.size();
+        mVariablesList.emplace_back(names[i].first, QString(), shared, names[i].second, end - names[i].second);
+    }
 }
 
 void Gdb::readErrOutput()
 {
     mBuffer = QProcess::readAllStandardError();
+    if(mSessionLog != nullptr)
+    {
+        mSessionLog->append(SessionLog::Log, mBuffer);
+    }
 }
 
 const QString &Gdb::getOutput() const
@@ -235,49 +584,308 @@ const QString &Gdb::getOutput() const
 
 void Gdb::openProject(const QString &fileName)
 {   //opens file $fileName$ in gdb to debug it via target exec and file
-    write(QByteArray("target exec ").append(fileName));
-    write(QByteArray("file ").append(fileName));
+    sendCommand(QString("target exec %1").arg(fileName));
+    sendCommand(QString("file %1").arg(fileName));
 //    write(QByteArray("set new-console on"));
 }
 
+void Gdb::openCore(const QString &executable, const QString &coreFile, ResultHandler handler)
+{   //load $executable$ with its $coreFile$ for post-mortem debugging. $handler$ gets result of core loading
+    //or error of executable loading, core isn't opened without symbols of its program
+    sendCommand(QString("-file-exec-and-symbols %1").arg(MiRecord::quote(executable)),
+                [this, coreFile, handler](const MiRecord& record)
+    {
+        if(record.getClass() != "done")
+        {
+            if(handler)
+            {
+                handler(record);
+            }
+            return;
+        }
+        sendCommand(QString("-target-select core %1").arg(MiRecord::quote(coreFile)), handler);
+    });
+}
+
 void Gdb::run()
 {   //run debugging
-    write(QByteArray("run"));
+    sendCommand("run", ResultHandler(), true, CommandScheduler::Execution);
 }
 
 void Gdb::stepOver()
 {   //goes to the next line of code
-    write(QByteArray("next"));
+    sendCommand("next", ResultHandler(), true, CommandScheduler::Execution);
 }
 
 void Gdb::setBreakPoint(unsigned int line)
 {   //set simple breakpoint at line $line$
-    write(QByteArray("b ").append(QString::number(line)));
+    sendCommand(QString("b %1").arg(line));
+}
+
+void Gdb::insertBreakpoint(const QString &location, const QString &condition,
+                           int ignoreCount, int thread, int hitLimit, int inferior)
+{   //set breakpoint at $location$. Condition, ignore count and thread are checked by GDB itself,
+    //so skipped hits don't stop target. GDB disables breakpoint after $hitLimit$ hits if it isn't 0.
+    //With $inferior$ other processes sharing the code don't stop at it
+    QString command("-break-insert");
+    QString fullCondition = condition.trimmed();
+    if(inferior > 0)
+    {
+        fullCondition = fullCondition.isEmpty() ? QString("$_inferior == %1").arg(inferior)
+                                                : QString("$_inferior == %1 && (%2)").arg(inferior).arg(fullCondition);
+    }
+    if(!fullCondition.isEmpty())
+    {
+        command.append(" -c ").append(MiRecord::quote(fullCondition));
+    }
+    if(ignoreCount > 0)
+    {
+        command.append(QString(" -i %1").arg(ignoreCount));
+    }
+    if(thread > 0)
+    {
+        command.append(QString(" -p %1").arg(thread));
+    }
+    command.append(' ').append(MiRecord::quote(location));
+    sendCommand(command, [this, hitLimit](const MiRecord& record)
+    {
+        if(record.getClass() != "done")
+        {
+            return;
+        }
+        updateBreakpoint(record["bkpt"]);
+        if(hitLimit > 0)
+        {   // -break-insert has no option for it, CLI command is the only way to give it to GDB
+            int number = record["bkpt"]["number"].getString().toInt();
+            auto found = std::find_if(mBreakpointsList.begin(), mBreakpointsList.end(),
+                                      [&](const Breakpoint& brk){return brk.getNumber() == number;});
+            if(found != mBreakpointsList.end())
+            {
+                found->setHitLimit(hitLimit);
+            }
+            sendCommand(QString("enable count %1 %2").arg(hitLimit).arg(number), [this, number](const MiRecord& record)
+            {
+                if(record.getClass() == "done")
+                {
+                    readBreakpoint(number);
+                }
+            });
+        }
+    });
+}
+
+void Gdb::deleteBreakpoint(int number)
+{   //delete breakpoint $number$. GDB doesn't notify about breakpoints deleted by MI command, so list is updated here
+    sendCommand(QString("-break-delete %1").arg(number), [this, number](const MiRecord& record)
+    {
+        if(record.getClass() != "done")
+        {
+            return;
+        }
+        auto found = std::find_if(mBreakpointsList.begin(), mBreakpointsList.end(),
+                                  [&](const Breakpoint& brk){return brk.getNumber() == number;});
+        if(found != mBreakpointsList.end())
+        {
+            mBreakpointsList.erase(found);
+            emit signalBreakpointsChanged();
+        }
+        mRecordingWatchpoints.erase(number);
+    });
+}
+
+void Gdb::insertWatchpoint(const QString &expression, Breakpoint::WatchKind kind, bool record, int capacity)
+{   //watch $expression$ for writes, reads or both. GDB uses hardware watchpoints where it can.
+    //Recording watchpoint is made by helper, it keeps the last $capacity$ hits inside GDB and target
+    //doesn't stop, so its history is read on the next stop only
+    if(record)
+    {
+        QString kindName = kind == Breakpoint::WatchRead ? "read" : kind == Breakpoint::WatchAccess ? "access" : "write";
+        QString command = QString("uidebugger-watch kind=%1 capacity=%2 %3").arg(kindName).arg(capacity).arg(expression);
+        sendCommand(command, [this](const MiRecord& record)
+        {
+            if(record.getClass() == "done" && mHelperOutput.startsWith("watch|"))
+            {
+                mRecordingWatchpoints.insert(mHelperOutput.mid(static_cast<int>(std::strlen("watch|"))).trimmed().toInt());
+            }
+            mHelperOutput.clear();
+        });
+        return;
+    }
+    QString command("-break-watch");
+    if(kind == Breakpoint::WatchRead)
+    {
+        command.append(" -r");
+    }
+    else if(kind == Breakpoint::WatchAccess)
+    {
+        command.append(" -a");
+    }
+    command.append(' ').append(MiRecord::quote(expression));
+    sendCommand(command, [this](const MiRecord& record)
+    {   // reply has only number and expression, GDB doesn't notify about breakpoints made by MI commands
+        /*
+            ^done,wpt={number="2",exp="list.size"}
+        */
+        if(record.getClass() != "done")
+        {
+            return;
+        }
+        QString number;
+        for(const char* key : {"wpt", "hw-rwpt", "hw-awpt"})
+        {
+            if(number.isEmpty())
+            {
+                number = record[key]["number"].getString();
+            }
+        }
+        readBreakpoint(number.toInt());
+    });
+}
+
+void Gdb::readWatchHistory()
+{   //take hits recording watchpoints collected since the last read
+    for(int number : mRecordingWatchpoints)
+    {
+        QString command = QString("uidebugger-watch-history from=%1 %2").arg(mWatchHistory.getNextIndex(number)).arg(number);
+        sendCommand(command, [this, number](const MiRecord& record)
+        {
+            if(record.getClass() == "done")
+            {
+                if(mWatchHistory.readRecorded(mHelperOutput))
+                {
+                    emit signalWatchHistoryChanged();
+                }
+            }
+            else if(!isCancelled(record))
+            {   // watchpoint is gone, e.g. its frame was left
+                mRecordingWatchpoints.erase(number);
+            }
+            mHelperOutput.clear();
+        }, false, CommandScheduler::View, getStopGroup());
+    }
+}
+
+const Inferiors &Gdb::getInferiors() const
+{
+    return mInferiors;
+}
+
+void Gdb::focusInferior(int number)
+{   //show inferior $number$ in views. Its thread of the last stop is selected and views are refreshed
+    //from that stop, other inferiors aren't touched
+    if(!setFocus(number))
+    {
+        return;
+    }
+    emit signalInferiorsChanged();
+    const Inferiors::Inferior* inferior = mInferiors.find(number);
+    int thread = inferior->currentThread != 0 ? inferior->currentThread
+                                              : inferior->threads.empty() ? 0 : *inferior->threads.begin();
+    if(thread == 0)
+    {   // not started or exited, only selected for commands like run
+        sendCommand(QString("inferior %1").arg(number), ResultHandler(), false);
+        return;
+    }
+    sendCommand(QString("-thread-select %1").arg(thread), [this, number](const MiRecord& record)
+    {
+        const Inferiors::Inferior* inferior = mInferiors.find(number);
+        if(record.getClass() == "done" && inferior != nullptr && inferior->state == Inferiors::Stopped
+                && mInferiors.getFocus() == number)
+        {
+            emit signalFocusChanged(inferior->lastStop.getType() == MiRecord::ExecAsync ? inferior->lastStop : record);
+        }
+    }, false);
+}
+
+bool Gdb::setFocus(int number)
+{   //locals are kept for every inferior, so views show ones read in inferior which gets focus
+    int previous = mInferiors.getFocus();
+    if(!mInferiors.setFocus(number))
+    {
+        return false;
+    }
+    if(previous != number)
+    {
+        mInferiorVariables[previous].swap(mVariablesList);
+        mVariablesList.clear();
+        auto found = mInferiorVariables.find(number);
+        if(found != mInferiorVariables.end())
+        {
+            mVariablesList.swap(found->second);
+            mInferiorVariables.erase(found);
+        }
+        emit signalUpdatedVariables();
+    }
+    return true;
+}
+
+void Gdb::setFollowStops(bool follow)
+{   //let every stop take focus, as if there was one inferior
+    mFollowStops = follow;
+}
+
+void Gdb::setForkPolicy(bool followChild, bool detachOnFork, bool newInferiorOnExec, bool scheduleMultiple)
+{   //what GDB does when program forks or execs. Without detaching every fork becomes inferior, with
+    //$scheduleMultiple$ all of them resume together, otherwise only the current one runs
+    sendCommand(QString("-gdb-set follow-fork-mode %1").arg(followChild ? "child" : "parent"));
+    sendCommand(QString("-gdb-set detach-on-fork %1").arg(detachOnFork ? "on" : "off"));
+    sendCommand(QString("-gdb-set follow-exec-mode %1").arg(newInferiorOnExec ? "new" : "same"));
+    sendCommand(QString("-gdb-set schedule-multiple %1").arg(scheduleMultiple ? "on" : "off"));
+}
+
+const WatchHistory &Gdb::getWatchHistory() const
+{
+    return mWatchHistory;
+}
+
+void Gdb::clearWatchHistory()
+{
+    mWatchHistory.clear();
 }
 
 void Gdb::clearBreakPoint(unsigned int line)
 {   //clear breakpoint at line $line$
-    write(QByteArray("clear ").append(QString::number(line)));
+    sendCommand(QString("clear %1").arg(line));
 }
 
 void Gdb::stepIn()
 {   //step into function under cursor
-    write(QByteArray("step"));
+    sendCommand("step", ResultHandler(), true, CommandScheduler::Execution);
 }
 
 void Gdb::stepOut()
 {   //step out of current function\method
-    write(QByteArray("finish"));
+    sendCommand("finish", ResultHandler(), true, CommandScheduler::Execution);
 }
 
 void Gdb::stopExecuting()
 {   //stop executing of target
-    write(QByteArray("kill"));
+    sendCommand("kill", ResultHandler(), true, CommandScheduler::Execution);
 }
 
 void Gdb::stepContinue()
 {   //continue normal executing to the next breakpoint or end of the programm
-    write(QByteArray("c"));
+    sendCommand("c", ResultHandler(), true, CommandScheduler::Execution);
+}
+
+void Gdb::reverseStep()
+{   //step back into function called on the previous line. Works only while target is recorded
+    sendCommand("-exec-step --reverse", ResultHandler(), true, CommandScheduler::Execution);
+}
+
+void Gdb::reverseNext()
+{   //go back to the previous line
+    sendCommand("-exec-next --reverse", ResultHandler(), true, CommandScheduler::Execution);
+}
+
+void Gdb::reverseFinish()
+{   //go back to the call of current function
+    sendCommand("-exec-finish --reverse", ResultHandler(), true, CommandScheduler::Execution);
+}
+
+void Gdb::reverseContinue()
+{   //run backwards to the previous breakpoint or the start of record
+    sendCommand("-exec-continue --reverse", ResultHandler(), true, CommandScheduler::Execution);
 }
 
 int Gdb::getCurrentLine()
@@ -287,7 +895,7 @@ int Gdb::getCurrentLine()
     ~"46\t\tcout << \"Finished main\";\n"
     ^done
     */
-    write(QByteArray("frame"));
+    sendCommand("frame");
     QProcess::waitForReadyRead();
     QRegExp rx(":\\d+"); //finds ':46'
     if(rx.indexIn(mBuffer) == -1)
@@ -310,9 +918,14 @@ void Gdb::updateBreakpointsList()
         ~"2       breakpoint     keep y   0x00401516 in main() at main.cpp:46\n"
         ^done
     */
-    write(QByteArray("info b"));
+    sendCommand("info b");
     QProcess::waitForReadyRead(1000);
     QStringList lines = mBuffer.split('~'); // split by CLI output lines
+    std::map<int, int> hitLimits; // GDB shows only hits left, keep limits user set
+    for(const Breakpoint& i : mBreakpointsList)
+    {
+        hitLimits[i.getNumber()] = i.getHitLimit();
+    }
     mBreakpointsList.clear(); // clear old info
     for(int i=2;i<lines.size();++i) //read all lines except of first two (command line and topic line)
     {
@@ -321,6 +934,7 @@ void Gdb::updateBreakpointsList()
         try
         {
             currentBreakpoint.parse(currentLine); // full breakpoint from $currentLine$
+            currentBreakpoint.setHitLimit(hitLimits[currentBreakpoint.getNumber()]);
             mBreakpointsList.push_back(currentBreakpoint); // write relevant breakpoint to vector
         }
         catch(std::exception)
@@ -329,33 +943,260 @@ void Gdb::updateBreakpointsList()
     }
 }
 
-std::vector<Breakpoint> Gdb::getBreakpoints() const
+const std::vector<Breakpoint> &Gdb::getBreakpoints() const
 {   //returns list of all breakpoint
     return mBreakpointsList;
 }
 
-std::vector<Variable> Gdb::getLocalVariables() const
+const std::vector<Variable> &Gdb::getLocalVariables() const
 {   //returns list of all variables
     return mVariablesList;
 }
 
 void Gdb::getVarContent(const QString& var)
-{   // Asks GDB about variable $var$ and calls signal which will pass relevant info
-    write(QByteArray("print ").append(var));
+{   // Asks GDB about variable $var$ and calls signal which will pass relevant info.
+    /* Value may be hundreds of megabytes, so it is streamed into PrintCapture as console records come
+       instead of being collected in mBuffer. Small values are passed by signalContentUpdated as before,
+       large ones by signalLargeContentCaptured to be shown lazily */
+    mPrintQueue.push_back(var);
+    if(!mPrintCapture)
+    {
+        startPrint();
+    }
 }
 
-QString Gdb::getVarType(Variable var)
+void Gdb::startPrint()
+{
+    const int largeContent = 1024*1024; // characters
+    mPrintCapture = std::make_shared<PrintCapture>(mPrintQueue.front());
+    mPrintQueue.pop_front();
+    mPrintReported = 0;
+    mPrintArmed = false;
+    QString command = QString("print %1").arg(mPrintCapture->getExpression());
+#ifndef Q_OS_UNIX
+    /* GDB can't be interrupted here, so print is limited to finish in reasonable time after cancel.
+       "with" changes settings only for this command */
+    const int printLimit = 100000;  // elements of every array
+    command = QString("with print elements %1 -- %2").arg(printLimit).arg(command);
+#endif
+    /* command is queued now but GDB may still be answering earlier ones, whose "$N = " output
+       must not be captured. Helper writes a marker right before the print, see handlePrintOutput */
+    command = QString("uidebugger-print %1").arg(command);
+    sendCommand(QString("-interpreter-exec console %1").arg(MiRecord::quote(command)), [this, largeContent](const MiRecord& record)
+    {
+        PrintCapturePtr capture = mPrintCapture;
+        mPrintCapture.reset();
+        mPrintArmed = false;
+        capture->finish(record.getClass() == "done");
+        if(capture->isDone() && capture->size() <= largeContent)
+        {
+            emit signalContentUpdated(Variable(capture->getExpression(), "", capture->readAll()));
+        }
+        else if(capture->size() > 0)
+        {
+            emit signalLargeContentCaptured(capture);
+        }
+        emit signalPrintProgress(capture->getExpression(), -1);
+        if(!mPrintQueue.empty())
+        {
+            startPrint();
+        }
+    }, false, CommandScheduler::View, getStopGroup());
+}
+
+bool Gdb::handlePrintOutput(const QString &stream)
+{   //pass console output of current print to its capture
+    if(!mPrintCapture)
+    {
+        return false;
+    }
+    if(!mPrintArmed)
+    {   // output before the marker belongs to other commands
+        mPrintArmed = stream == printMarker;
+        return mPrintArmed;
+    }
+    const qint64 reportStep = 1024*1024;
+    if(!mPrintCapture->append(stream))
+    {
+        return false;
+    }
+    if(mPrintCapture->size() - mPrintReported >= reportStep)
+    {
+        mPrintReported = mPrintCapture->size();
+        emit signalPrintProgress(mPrintCapture->getExpression(), mPrintReported);
+    }
+    return true;
+}
+
+void Gdb::cancelPrint()
+{   //stop print GDB is doing now. GDB is interrupted where it is possible, otherwise the rest
+    //of value is dropped as it comes and print is bounded by element limit set in startPrint
+    if(!mPrintCapture)
+    {
+        return;
+    }
+    mPrintCapture->cancel();
+#ifdef Q_OS_UNIX
+    ::kill(static_cast<pid_t>(processId()), SIGINT);
+#endif
+}
+
+bool Gdb::isPrinting() const
+{
+    return mPrintCapture != nullptr;
+}
+
+QString Gdb::getVarType(const Variable &var)
 {   // Asks GDB about vairable $var$ and calls signal which will pass relevant info
+    /* type comes as console output and is read by readType, handler only forgets variable
+       when no type will come */
     mVariableTypeQueue.push_back(var);
-    write(QByteArray("whatis ").append(var.getName()));
+    QString name = var.getName();
+    sendCommand(QString("whatis %1").arg(name), [this, name](const MiRecord& record)
+    {
+        if(record.getClass() != "error")
+        {
+            return;
+        }
+        auto found = std::find_if(mVariableTypeQueue.begin(), mVariableTypeQueue.end(),
+                                  [&](const Variable& var){return var.getName() == name;});
+        if(found != mVariableTypeQueue.end())
+        {
+            mVariableTypeQueue.erase(found);
+        }
+    }, true, CommandScheduler::View, getStopGroup());
     return QString();
 }
 
 void Gdb::updateVariable64x()
 {   // Updates all variables
     mVariablesList.clear();
-    write(QByteArray("info local"));
-    write(QByteArray("info arg"));
+    sendCommand("info local", ResultHandler(), true, CommandScheduler::View, getStopGroup());
+    sendCommand("info arg", ResultHandler(), true, CommandScheduler::View, getStopGroup());
+}
+
+int Gdb::setLogpoint(const QString &location, const QString &format, const QString &arguments)
+{   //set dprintf at $location$ which prints $format$ with comma separated $arguments$ and continues.
+    //Returns id of logpoint in hit log
+    int id = mNextLogpointId++;
+    mLogpoints[id] = Logpoint{id, 0, location, format, arguments};
+
+    QString command = QString("-dprintf-insert %1 %2").arg(MiRecord::quote(location))
+            .arg(MiRecord::quote(QString("%1%2|%3\n").arg(logpointMarker).arg(id).arg(format)));
+    int level = 0;
+    QString argument;
+    for(QChar ch : arguments + ',')
+    {   // split arguments by commas which are not inside brackets
+        if(ch == '(' || ch == '[' || ch == '{')
+        {
+            ++level;
+        }
+        if(ch == ')' || ch == ']' || ch == '}')
+        {
+            --level;
+        }
+        if(ch == ',' && level == 0)
+        {
+            if(!argument.trimmed().isEmpty())
+            {
+                command.append(' ').append(MiRecord::quote(argument.trimmed()));
+            }
+            argument.clear();
+            continue;
+        }
+        argument.append(ch);
+    }
+    sendCommand(command, [this, id](const MiRecord& record)
+    {
+        auto logpoint = mLogpoints.find(id);
+        if(logpoint == mLogpoints.end())
+        {   // logpoint was removed before GDB created it
+            if(record.getClass() == "done")
+            {
+                sendCommand(QString("-break-delete %1").arg(record["bkpt"]["number"].getString()));
+            }
+            return;
+        }
+        if(record.getClass() != "done")
+        {
+            mLogpoints.erase(logpoint);
+            return;
+        }
+        logpoint->second.number = record["bkpt"]["number"].getString().toInt();
+        mLogpointByNumber[logpoint->second.number] = id;
+    });
+    return id;
+}
+
+void Gdb::removeLogpoint(int id)
+{   //delete dprintf of logpoint $id$. Its hits stay in hit log
+    auto logpoint = mLogpoints.find(id);
+    if(logpoint == mLogpoints.end())
+    {
+        return;
+    }
+    if(logpoint->second.number != 0)
+    {
+        sendCommand(QString("-break-delete %1").arg(logpoint->second.number));
+        mLogpointByNumber.erase(logpoint->second.number);
+    }
+    mLogpoints.erase(logpoint);
+}
+
+const std::map<int, Logpoint> &Gdb::getLogpoints() const
+{
+    return mLogpoints;
+}
+
+const HitLog &Gdb::getHitLog() const
+{
+    return mHitLog;
+}
+
+void Gdb::clearHitLog()
+{
+    mHitLog.clear();
+}
+
+void Gdb::loadHelpers()
+{   //source Python helper commands into GDB. Script is copied from resources because GDB can't read them
+    if(!mHelperScript.isOpen())
+    {
+        QFile script(":/helpers/uidebugger.py");
+        mHelperScript.setFileTemplate(QDir::tempPath().append("/uidebuggerXXXXXX.py"));
+        if(!script.open(QIODevice::ReadOnly) || !mHelperScript.open())
+        {
+            emit signalErrorOccured(tr("Can't load GDB helpers"));
+            return;
+        }
+        mHelperScript.write(script.readAll());
+        mHelperScript.flush();
+    }
+    sendCommand(QString("source %1").arg(mHelperScript.fileName()));
+}
+
+const QString &Gdb::getHelperOutput() const
+{   //output of the last helper command, valid in its result handler
+    return mHelperOutput;
+}
+
+void Gdb::walkStructure(const QString &root, const QStringList &links, const QStringList &values, int maxNodes)
+{   //walk linked structure from $root$ following $links$ fields inside GDB, so all nodes
+    //come in one reply instead of print and whatis per node
+    QString command = QString("uidebugger-walk max=%1 links=%2 ").arg(maxNodes).arg(links.join(','));
+    if(!values.isEmpty())
+    {
+        command.append(QString("values=%1 ").arg(values.join(',')));
+    }
+    command.append(root);
+    sendCommand(command, [this](const MiRecord& record)
+    {
+        if(record.getClass() == "done")
+        {
+            emit signalStructureWalked(StructureWalk::parse(mHelperOutput));
+        }
+        mHelperOutput.clear();
+    });
 }
 
 void Gdb::setGdbPath(const QString &path)
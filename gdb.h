@@ -4,51 +4,103 @@
 #include <QProcess>
 #include <QFile>
 #include <QStringList>
+#include <QTemporaryFile>
+#include <QElapsedTimer>
 
 #include <vector>
 #include <queue>
 #include <list>
+#include <map>
+#include <set>
+#include <functional>
 
 #include "breakpoint.h"
 #include "variable.h"
+#include "mirecord.h"
+#include "milinesplitter.h"
+#include "hitlog.h"
+#include "structurewalk.h"
+#include "printcapture.h"
+#include "commandscheduler.h"
+#include "sessionlog.h"
+#include "watchhistory.h"
+#include "inferiors.h"
 
 class Gdb : public QProcess
 {
     Q_OBJECT
 public:
+    typedef std::function<void(const MiRecord&)> ResultHandler;
     Gdb();
     Gdb(QString gdbPath);
     void start(const QStringList &arguments = QStringList() << "--interpreter=mi",
                 QProcess::OpenMode mode = QIODevice::ReadWrite);
     void write(QByteArray &command);
+    int sendCommand(const QString& command, ResultHandler handler = ResultHandler(), bool echo = true,
+                    CommandScheduler::Priority priority = CommandScheduler::Interactive,
+                    const QString& group = QString());
+    int cancelCommands(const QString& group);
+    CommandScheduler& getScheduler();
+    static bool isCancelled(const MiRecord& record);
+    static const QString& getStopGroup();
+    void setSessionLog(SessionLog* log);
     void readStdOutput();
     void readErrOutput();
 
     const QString& getOutput()const;
     void openProject(const QString& fileName);
+    void openCore(const QString& executable, const QString& coreFile, ResultHandler handler);
     void run();
     void stepOver();
     void setBreakPoint(unsigned int line);
+    void insertBreakpoint(const QString& location, const QString& condition = QString(),
+                          int ignoreCount = 0, int thread = -1, int hitLimit = 0, int inferior = 0);
     void clearBreakPoint(unsigned int line);
+    void deleteBreakpoint(int number);
+    void insertWatchpoint(const QString& expression, Breakpoint::WatchKind kind,
+                          bool record = false, int capacity = 10000);
+    void readWatchHistory();
+    const WatchHistory& getWatchHistory()const;
+    void clearWatchHistory();
+    const Inferiors& getInferiors()const;
+    void focusInferior(int number);
+    void setFollowStops(bool follow);
+    void setForkPolicy(bool followChild, bool detachOnFork, bool newInferiorOnExec, bool scheduleMultiple);
     void stepIn();
     void stepOut();
     void stopExecuting();
     void stepContinue();
+    void reverseStep();
+    void reverseNext();
+    void reverseFinish();
+    void reverseContinue();
     int getCurrentLine();
     void updateBreakpointsList();
-    std::vector<Breakpoint> getBreakpoints()const;
-    std::vector<Variable> getLocalVariables()const;
+    const std::vector<Breakpoint>& getBreakpoints()const;
+    const std::vector<Variable>& getLocalVariables()const;
     void getVarContent(const QString& var);
-    QString getVarType(Variable var);
+    void cancelPrint();
+    bool isPrinting()const;
+    QString getVarType(const Variable& var);
     void globalUpdate();
     void setGdbPath(const QString& path);
 
     void readType(const QString& varName);
-    void readContent(const QString& context);
     void updateVariable64x();
     void updateVariableFromBuffer();
     QString getVarContentFromContext(const QString& context);
 
+    int setLogpoint(const QString& location, const QString& format, const QString& arguments);
+    void removeLogpoint(int id);
+    const std::map<int, Logpoint>& getLogpoints()const;
+    const HitLog& getHitLog()const;
+    void clearHitLog();
+
+    void loadHelpers();
+    const QString& getHelperOutput()const;
+    void walkStructure(const QString& root, const QStringList& links,
+                       const QStringList& values, int maxNodes);
+
 public slots:
     void slotReadStdOutput();
     void slotReadErrOutput();
@@ -58,25 +110,75 @@ signals:
     void signalLocalVarRecieved(const QString&);
     void signalErrorOccured(const QString&);
     void signalUpdatedVariables();
-    void signalTypeUpdated(Variable var);
-    void signalContentUpdated(Variable var);
+    void signalTypeUpdated(const Variable& var);
+    void signalContentUpdated(const Variable& var);
     void signalReadyReadGdb();
+    void signalBreakpointsChanged();
+    void signalStopped(const MiRecord& record);
+    void signalRunning();
+    void signalInferiorStarted();
+    void signalConsoleOutput(const QString& text);
+    void signalNotification(const MiRecord& record);
+    void signalStructureWalked(const StructureWalk& walk);
+    void signalPrintProgress(const QString& expression, qint64 size);
+    void signalLargeContentCaptured(const PrintCapturePtr& capture);
+    void signalWatchHistoryChanged();
+    void signalStopSettled(qint64 elapsed, int commands);
+    void signalInferiorsChanged();
+    void signalFocusChanged(const MiRecord& lastStop);
+    void signalBackgroundStopped(const MiRecord& record);
 private:
+    bool handleRecord(const MiRecord& record);
+    bool handleLogpointOutput(const QString& stream);
+    bool handleHelperOutput(const QString& stream);
+    bool handlePrintOutput(const QString& stream);
+    void startPrint();
+    void updateBreakpoint(const MiValue& bkpt);
+    void readBreakpoint(int number);
+    void writeScheduled();
+    void checkStopSettled();
+    bool routeStop(const MiRecord& stopped);
+    bool setFocus(int number);
+
     QFile mGdbFile;
     QString mErrorMessage;
     QString mBuffer;
     std::vector<Breakpoint> mBreakpointsList;
     std::vector<Variable> mVariablesList;
+    std::map<int, std::vector<Variable>> mInferiorVariables;    // locals of not focused inferiors
 
 
     QString temp;
     bool mInfoCaptured;
     bool mWhatisCaptured;
     QString mWhatisBuffer;
-    QString mPrintBuffer;
     bool collect;
     std::list<Variable> mVariableTypeQueue;
-    bool mPrintCaptured;
+
+    MiLineSplitter mLineSplitter;
+    int mNextToken;
+    std::map<int, ResultHandler> mPendingCommands;
+    std::set<int> mSilentCommands;
+    CommandScheduler mScheduler;
+    SessionLog* mSessionLog;    // not owned, may be nullptr
+    int mNextLogpointId;
+    std::map<int, Logpoint> mLogpoints;
+    std::map<int, int> mLogpointByNumber;
+    HitLog mHitLog;
+    QTemporaryFile mHelperScript;
+    bool mHelperCapture;
+    QString mHelperOutput;
+    std::list<QString> mPrintQueue;
+    PrintCapturePtr mPrintCapture;  // print GDB is doing now
+    bool mPrintArmed;   // marker of print came, earlier console output isn't its
+    qint64 mPrintReported;
+    WatchHistory mWatchHistory;
+    std::set<int> mRecordingWatchpoints;    // watchpoints of helper which record hits and don't stop
+    QElapsedTimer mStopClock;   // since the last stop, until all commands it caused are answered
+    bool mStopSettling;
+    int mStopCommands;
+    Inferiors mInferiors;
+    bool mFollowStops;      // stop of other inferior takes focus even if focused one is stopped
 };
 
 #endif // GDB_H
@@ -0,0 +1,327 @@
+# Helper commands which UiDebuggerGdb sources into GDB.
+# Every command frames its output with @uidbg-begin and @uidbg-end lines,
+# so the frontend can take it from console stream as one record.
+
+import collections
+import re
+
+import gdb
+
+
+def begin_output():
+    gdb.write("@uidbg-begin\n")
+    gdb.flush()
+
+
+def end_output(lines):
+    lines.append("@uidbg-end")
+    gdb.write("\n".join(lines) + "\n")
+    gdb.flush()
+
+
+def escape(text):
+    return text.replace("\\", "\\\\").replace("|", "\\p").replace("\n", "\\n")
+
+
+def parse_options(argument, options):
+    """Split leading key=value words listed in options from the rest of argument."""
+    words = argument.split(" ")
+    while words and "=" in words[0] and words[0].split("=", 1)[0] in options:
+        key, value = words.pop(0).split("=", 1)
+        options[key] = value
+    return " ".join(words).strip()
+
+
+class WalkCommand(gdb.Command):
+    """Walk linked structure starting at pointer EXPRESSION.
+
+Usage: uidebugger-walk [max=N] [links=FIELD,...] [values=FIELD,...] EXPRESSION
+
+Nodes are visited breadth-first following every link field, up to N nodes.
+Output is one line per node: node|index|parent|link|address|values, where values
+are the listed fields of node separated by '|'. Node which was already visited
+is reported as ref|index|parent|link|address|FIRST, FIRST being index of its
+first visit, and isn't followed again."""
+
+    def __init__(self):
+        super(WalkCommand, self).__init__("uidebugger-walk", gdb.COMMAND_DATA)
+
+    def invoke(self, argument, from_tty):
+        options = {"max": "10000", "links": "next", "values": ""}
+        expression = parse_options(argument, options)
+        limit = int(options["max"])
+        links = [i for i in options["links"].split(",") if i]
+        values = [i for i in options["values"].split(",") if i]
+
+        root = gdb.parse_and_eval(expression)
+        if root.type.strip_typedefs().code != gdb.TYPE_CODE_PTR:
+            root = root.address
+
+        lines = []
+        visited = {}
+        queue = collections.deque([(root, -1, "")] if int(root) != 0 else [])
+        while queue and len(lines) < limit:
+            node, parent, link = queue.popleft()
+            address = int(node)
+            index = len(lines)
+            if address in visited:
+                lines.append("ref|%d|%d|%s|0x%x|%d" % (index, parent, link, address, visited[address]))
+                continue
+            visited[address] = index
+            record = "node|%d|%d|%s|0x%x" % (index, parent, link, address)
+            try:
+                target = node.dereference()
+                for field in values:
+                    record += "|" + escape(str(target[field]))
+                for field in links:
+                    child = target[field]
+                    if int(child) != 0:
+                        queue.append((child, index, field))
+            except gdb.error as error:
+                record += "|<" + escape(str(error)) + ">"
+            lines.append(record)
+
+        truncated = 1 if queue else 0
+        begin_output()
+        end_output(["walk|%d|%d" % (len(lines), truncated)] + lines)
+
+
+WalkCommand()
+
+
+class BuildIdCommand(gdb.Command):
+    """Print build-id of the program being debugged.
+
+Usage: uidebugger-build-id
+
+Output is one line build-id|HEX. HEX is empty if program has no build-id,
+for example PE executables."""
+
+    def __init__(self):
+        super(BuildIdCommand, self).__init__("uidebugger-build-id", gdb.COMMAND_FILES)
+
+    def invoke(self, argument, from_tty):
+        build_id = ""
+        filename = gdb.current_progspace().filename
+        for objfile in gdb.objfiles():
+            if objfile.filename == filename:
+                build_id = getattr(objfile, "build_id", None) or ""
+                break
+        begin_output()
+        end_output(["build-id|%s" % build_id])
+
+
+BuildIdCommand()
+
+
+WATCH_KINDS = {"write": gdb.WP_WRITE, "read": gdb.WP_READ, "access": gdb.WP_ACCESS}
+
+
+class RecordingWatchpoint(gdb.Breakpoint):
+    """Watchpoint which records its hits and never stops the program.
+
+stop() runs inside GDB on every hit, so nothing is sent to the frontend until
+history is asked for and the program runs at GDB speed."""
+
+    def __init__(self, expression, kind, capacity):
+        super(RecordingWatchpoint, self).__init__(expression, gdb.BP_WATCHPOINT, WATCH_KINDS[kind])
+        self.expression = expression
+        self.kind = kind
+        self.history = collections.deque(maxlen=capacity)
+        self.sites = collections.Counter()
+        self.total = 0
+        self.last = self.read_value()
+
+    def read_value(self):
+        try:
+            return str(gdb.parse_and_eval(self.expression))
+        except gdb.error as error:
+            return "<%s>" % error
+
+    def stop(self):
+        self.total += 1
+        value = self.read_value()
+        frame = gdb.newest_frame()
+        sal = frame.find_sal()
+        function = frame.name() or ""
+        location = "%s:%d" % (sal.symtab.filename, sal.line) if sal.symtab else ""
+        self.sites[(function, location)] += 1
+        old = self.last if self.kind != "read" else value
+        self.history.append((self.total, gdb.selected_thread().num, frame.pc(), function, location, old, value))
+        self.last = value
+        return False
+
+
+recording_watchpoints = {}
+
+
+class WatchCommand(gdb.Command):
+    """Set watchpoint which records value history instead of stopping.
+
+Usage: uidebugger-watch [kind=write|read|access] [capacity=N] EXPRESSION
+
+Output is one line watch|NUMBER. The last N hits are kept, see
+uidebugger-watch-history."""
+
+    def __init__(self):
+        super(WatchCommand, self).__init__("uidebugger-watch", gdb.COMMAND_BREAKPOINTS)
+
+    def invoke(self, argument, from_tty):
+        options = {"kind": "write", "capacity": "10000"}
+        expression = parse_options(argument, options)
+        if options["kind"] not in WATCH_KINDS:
+            raise gdb.GdbError("Unknown watchpoint kind %s" % options["kind"])
+        watchpoint = RecordingWatchpoint(expression, options["kind"], int(options["capacity"]))
+        recording_watchpoints[watchpoint.number] = watchpoint
+        begin_output()
+        end_output(["watch|%d" % watchpoint.number])
+
+
+WatchCommand()
+
+
+class WatchHistoryCommand(gdb.Command):
+    """Print hits recorded by watchpoint NUMBER set with uidebugger-watch.
+
+Usage: uidebugger-watch-history [from=INDEX] NUMBER
+
+Output starts with history|NUMBER|HITS, where HITS counts all hits including
+dropped from history. Then hits with index INDEX and later follow, one line
+hit|index|thread|pc|function|location|old|new each, and lines
+site|function|location|count with hits of every place the value was touched."""
+
+    def __init__(self):
+        super(WatchHistoryCommand, self).__init__("uidebugger-watch-history", gdb.COMMAND_BREAKPOINTS)
+
+    def invoke(self, argument, from_tty):
+        options = {"from": "0"}
+        number = int(parse_options(argument, options))
+        first = int(options["from"])
+        watchpoint = recording_watchpoints.get(number)
+        if watchpoint is None or not watchpoint.is_valid():
+            recording_watchpoints.pop(number, None)
+            raise gdb.GdbError("No recording watchpoint %d" % number)
+        lines = ["history|%d|%d" % (number, watchpoint.total)]
+        for index, thread, pc, function, location, old, new in watchpoint.history:
+            if index >= first:
+                lines.append("hit|%d|%d|0x%x|%s|%s|%s|%s" % (index, thread, pc, escape(function),
+                                                             escape(location), escape(old), escape(new)))
+        for (function, location), count in watchpoint.sites.items():
+            lines.append("site|%s|%s|%d" % (escape(function), escape(location), count))
+        begin_output()
+        end_output(lines)
+
+
+WatchHistoryCommand()
+
+
+RECORD_NUMBERS = {"lowest": r"Lowest recorded instruction number is (\d+)",
+                  "highest": r"Highest recorded instruction number is (\d+)",
+                  "count": r"Log contains (\d+) instructions",
+                  "max": r"Max logged instructions is (\d+)",
+                  "current": r"Current instruction number is (\d+)"}
+
+
+class RecordInfoCommand(gdb.Command):
+    """Print state of process record.
+
+Usage: uidebugger-record-info
+
+Output is one line record|METHOD|LOWEST|HIGHEST|COUNT|MAX|CURRENT. METHOD is
+empty when nothing is recorded. CURRENT is the instruction being replayed,
+0 when target runs live at the end of the log."""
+
+    def __init__(self):
+        super(RecordInfoCommand, self).__init__("uidebugger-record-info", gdb.COMMAND_RUNNING)
+
+    def invoke(self, argument, from_tty):
+        text = gdb.execute("info record", to_string=True)
+        method = re.search(r"Active record target: (\S+)", text)
+        numbers = {}
+        for key, pattern in RECORD_NUMBERS.items():
+            found = re.search(pattern, text)
+            numbers[key] = int(found.group(1)) if found else 0
+        begin_output()
+        end_output(["record|%s|%d|%d|%d|%d|%d" % (method.group(1) if method else "", numbers["lowest"],
+                                                 numbers["highest"], numbers["count"], numbers["max"],
+                                                 numbers["current"])])
+
+
+RecordInfoCommand()
+
+
+class CheckpointCommand(gdb.Command):
+    """Fork the program being debugged, so it can be restarted from this point.
+
+Usage: uidebugger-checkpoint
+
+Output is one line checkpoint|NUMBER|PID."""
+
+    def __init__(self):
+        super(CheckpointCommand, self).__init__("uidebugger-checkpoint", gdb.COMMAND_RUNNING)
+
+    def invoke(self, argument, from_tty):
+        text = gdb.execute("checkpoint", to_string=True)
+        found = re.search(r"checkpoint (\d+): fork returned pid (\d+)", text)
+        if found is None:
+            raise gdb.GdbError(text.strip() or "Checkpoint failed")
+        begin_output()
+        end_output(["checkpoint|%s|%s" % (found.group(1), found.group(2))])
+
+
+CheckpointCommand()
+
+
+class EvalCommand(gdb.Command):
+    """Evaluate EXPRESSION within size limits.
+
+Usage: uidebugger-eval [chars=N] [elements=N] [bytes=N] EXPRESSION
+
+At most N bytes of value are read from target and at most N elements of
+arrays and containers are printed. Output is eval|TRUNCATED|TYPE|VALUE where
+VALUE is cut to N characters and TRUNCATED is 1 when it was cut."""
+
+    def __init__(self):
+        super(EvalCommand, self).__init__("uidebugger-eval", gdb.COMMAND_DATA)
+
+    def invoke(self, argument, from_tty):
+        options = {"chars": "4096", "elements": "100", "bytes": "65536"}
+        expression = parse_options(argument, options)
+        chars = int(options["chars"])
+        old_size = gdb.parameter("max-value-size")
+        gdb.execute("set max-value-size %d" % max(int(options["bytes"]), 16), to_string=True)
+        try:
+            value = gdb.parse_and_eval(expression)
+            try:
+                text = value.format_string(max_elements=int(options["elements"]))
+            except AttributeError:
+                text = str(value)
+            type_name = str(value.type)
+        finally:
+            gdb.execute("set max-value-size %s" % ("unlimited" if old_size is None else old_size),
+                        to_string=True)
+        truncated = len(text) > chars
+        begin_output()
+        end_output(["eval|%d|%s|%s" % (1 if truncated else 0, escape(type_name), escape(text[:chars]))])
+
+
+EvalCommand()
+
+
+class PrintCommand(gdb.Command):
+    """Run print COMMAND after a line marking where its output begins.
+
+Usage: uidebugger-print COMMAND
+
+Output is @uidbg-print followed by console output of COMMAND as it comes."""
+
+    def __init__(self):
+        super(PrintCommand, self).__init__("uidebugger-print", gdb.COMMAND_DATA)
+
+    def invoke(self, argument, from_tty):
+        gdb.write("@uidbg-print\n")
+        gdb.flush()
+        gdb.execute(argument, from_tty)
+
+
+PrintCommand()
@@ -0,0 +1,84 @@
+#include "hitlog.h"
+
+static const qint64 rateWindow = 1000; // milliseconds
+
+HitLog::HitLog(int capacity, int maxMessageLength):
+    mCapacity{capacity},
+    mMaxMessageLength{maxMessageLength},
+    mEndIndex{0}
+{
+    mClock.start();
+}
+
+void HitLog::append(int logpoint, const QString &message)
+{   // append hit of $logpoint$ to the end of log. The oldest hit is dropped if log is full
+    qint64 now = mClock.elapsed();
+    Hit hit{mEndIndex++, now, logpoint, message.left(mMaxMessageLength)};
+    mHits.push_back(std::move(hit));
+    if(static_cast<int>(mHits.size()) > mCapacity)
+    {
+        mHits.pop_front();
+    }
+
+    Stats& stats = mStats[logpoint];
+    ++stats.count;
+    ++stats.windowCount;
+    qint64 elapsed = now - stats.windowStart;
+    if(elapsed >= rateWindow)
+    {
+        stats.rate = stats.windowCount * 1000.0 / elapsed;
+        stats.windowStart = now;
+        stats.windowCount = 0;
+    }
+}
+
+void HitLog::clear()
+{   // drop all hits and counters. Indexes continue from the last one
+    mHits.clear();
+    mStats.clear();
+}
+
+qint64 HitLog::firstIndex() const
+{   // index of the oldest hit still stored in log
+    return mEndIndex - static_cast<qint64>(mHits.size());
+}
+
+qint64 HitLog::endIndex() const
+{   // index which the next hit will get
+    return mEndIndex;
+}
+
+const HitLog::Hit &HitLog::at(qint64 index) const
+{   // $index$ should be in [firstIndex(), endIndex())
+    return mHits[static_cast<size_t>(index - firstIndex())];
+}
+
+int HitLog::size() const
+{
+    return static_cast<int>(mHits.size());
+}
+
+int HitLog::getCapacity() const
+{
+    return mCapacity;
+}
+
+const std::map<int, HitLog::Stats> &HitLog::getStats() const
+{
+    return mStats;
+}
+
+double HitLog::getRate(int logpoint) const
+{   // hits per second of $logpoint$. Goes down to zero if logpoint is quiet for a whole window
+    auto found = mStats.find(logpoint);
+    if(found == mStats.end())
+    {
+        return 0;
+    }
+    qint64 elapsed = mClock.elapsed() - found->second.windowStart;
+    if(elapsed >= 2*rateWindow)
+    {
+        return found->second.windowCount * 1000.0 / elapsed;
+    }
+    return found->second.rate;
+}
@@ -0,0 +1,56 @@
+#ifndef HITLOG_H
+#define HITLOG_H
+
+#include <QString>
+#include <QElapsedTimer>
+
+#include <deque>
+#include <map>
+
+struct Logpoint
+{   // breakpoint which prints message via dprintf and never stops target
+    int id;
+    int number;         // GDB breakpoint number, 0 until GDB answers
+    QString location;
+    QString format;
+    QString arguments;
+};
+
+class HitLog
+{
+public:
+    struct Hit
+    {
+        qint64 index;       // sequence number of hit, never reused
+        qint64 time;        // milliseconds since log was created
+        int logpoint;
+        QString message;
+    };
+    struct Stats
+    {
+        qint64 count = 0;   // total hits, including dropped from log
+        qint64 windowStart = 0;
+        qint64 windowCount = 0;
+        double rate = 0;    // hits per second during last measured window
+    };
+
+    explicit HitLog(int capacity = 100000, int maxMessageLength = 512);
+    void append(int logpoint, const QString& message);
+    void clear();
+    qint64 firstIndex()const;
+    qint64 endIndex()const;
+    const Hit& at(qint64 index)const;
+    int size()const;
+    int getCapacity()const;
+    const std::map<int, Stats>& getStats()const;
+    double getRate(int logpoint)const;
+private:
+    int mCapacity;
+    int mMaxMessageLength;
+    qint64 mEndIndex;
+    std::deque<Hit> mHits;
+    std::map<int, Stats> mStats;
+    QElapsedTimer mClock;
+};
+
+#endif // HITLOG_H
@@ -0,0 +1,79 @@
+#include "hitlogmodel.h"
+
+HitLogModel::HitLogModel(const HitLog &log, QObject *parent):
+    QAbstractTableModel(parent),
+    mLog(log),
+    mFirst{log.firstIndex()},
+    mEnd{log.endIndex()}
+{
+}
+
+int HitLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(mEnd - mFirst);
+}
+
+int HitLogModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant HitLogModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || role != Qt::DisplayRole)
+    {
+        return QVariant();
+    }
+    const HitLog::Hit& hit = mLog.at(mFirst + index.row());
+    switch(index.column())
+    {
+    case Index: return hit.index;
+    case Time: return QString::number(hit.time / 1000.0, 'f', 3);
+    case LogpointId: return hit.logpoint;
+    case Message: return hit.message;
+    }
+    return QVariant();
+}
+
+QVariant HitLogModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if(orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch(section)
+    {
+    case Index: return tr("#");
+    case Time: return tr("Time, s");
+    case LogpointId: return tr("Logpoint");
+    case Message: return tr("Message");
+    }
+    return QVariant();
+}
+
+void HitLogModel::refresh()
+{   // synchronize rows with log: drop rows removed from log head and append new ones.
+    // Called by timer, so views are updated once per tick however many hits came
+    qint64 first = mLog.firstIndex();
+    qint64 end = mLog.endIndex();
+    if(first > mEnd)
+    {   // everything we show is already dropped
+        beginResetModel();
+        mFirst = first;
+        mEnd = end;
+        endResetModel();
+        return;
+    }
+    if(first > mFirst)
+    {
+        beginRemoveRows(QModelIndex(), 0, static_cast<int>(first - mFirst) - 1);
+        mFirst = first;
+        endRemoveRows();
+    }
+    if(end > mEnd)
+    {
+        beginInsertRows(QModelIndex(), static_cast<int>(mEnd - mFirst), static_cast<int>(end - mFirst) - 1);
+        mEnd = end;
+        endInsertRows();
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef HITLOGMODEL_H
+#define HITLOGMODEL_H
+
+#include <QAbstractTableModel>
+
+#include "hitlog.h"
+
+class HitLogModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column{Index, Time, LogpointId, Message, ColumnCount};
+    explicit HitLogModel(const HitLog& log, QObject* parent = 0);
+    int rowCount(const QModelIndex& parent = QModelIndex())const override;
+    int columnCount(const QModelIndex& parent = QModelIndex())const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole)const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole)const override;
+    void refresh();
+private:
+    const HitLog& mLog;
+    qint64 mFirst;  // range of hit indexes the view knows about
+    qint64 mEnd;
+};
+
+#endif // HITLOGMODEL_H
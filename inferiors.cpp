@@ -0,0 +1,182 @@
+#include "inferiors.h"
+
+Inferiors::Inferiors():
+    mFocus{1}
+{
+}
+
+bool Inferiors::read(const MiRecord &record)
+{   //update inferiors from notification or exec record. Returns false for records which don't change them
+    /*
+        =thread-group-added,id="i2"
+        =thread-group-started,id="i2",pid="1235"
+        =thread-created,id="3",group-id="i2"
+        =thread-exited,id="3",group-id="i2"
+        =thread-group-exited,id="i2",exit-code="0"
+        =thread-group-removed,id="i2"
+        *running,thread-id="all"
+        *stopped,reason="breakpoint-hit",...,thread-id="3",stopped-threads="all"
+    */
+    const QString& kind = record.getClass();
+    if(record.getType() == MiRecord::NotifyAsync)
+    {
+        if(kind == "thread-group-added")
+        {
+            get(parseId(record["id"].getString()));
+        }
+        else if(kind == "thread-group-removed")
+        {
+            int number = parseId(record["id"].getString());
+            mInferiors.erase(number);
+            if(mFocus == number)
+            {
+                mFocus = mInferiors.empty() ? 1 : mInferiors.begin()->first;
+            }
+        }
+        else if(kind == "thread-group-started")
+        {
+            Inferior& inferior = get(parseId(record["id"].getString()));
+            inferior.pid = record["pid"].getString().toLongLong();
+            inferior.state = Running;
+            inferior.exitCode.clear();
+            inferior.stops = 0;
+        }
+        else if(kind == "thread-group-exited")
+        {
+            Inferior& inferior = get(parseId(record["id"].getString()));
+            inferior.state = Exited;
+            inferior.exitCode = record["exit-code"].getString();
+            for(int i : inferior.threads)
+            {
+                mThreadInferiors.erase(i);
+            }
+            inferior.threads.clear();
+        }
+        else if(kind == "thread-created")
+        {
+            int number = parseId(record["group-id"].getString());
+            int thread = record["id"].getString().toInt();
+            get(number).threads.insert(thread);
+            mThreadInferiors[thread] = number;
+        }
+        else if(kind == "thread-exited")
+        {
+            int thread = record["id"].getString().toInt();
+            get(parseId(record["group-id"].getString())).threads.erase(thread);
+            mThreadInferiors.erase(thread);
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+    if(record.getType() != MiRecord::ExecAsync)
+    {
+        return false;
+    }
+    QString thread = record["thread-id"].getString();
+    if(kind == "running")
+    {
+        if(thread == "all")
+        {
+            for(auto& i : mInferiors)
+            {
+                if(i.second.state == Stopped)
+                {
+                    i.second.state = Running;
+                }
+            }
+        }
+        else if(int number = findByThread(thread.toInt()))
+        {
+            get(number).state = Running;
+        }
+        return true;
+    }
+    if(kind == "stopped")
+    {   // exit stops have no thread, inferior is marked by thread-group-exited
+        int number = findByThread(thread.toInt());
+        if(number == 0)
+        {
+            return false;
+        }
+        if(record["stopped-threads"].getString() == "all")
+        {   // all-stop mode, GDB stopped every process
+            for(auto& i : mInferiors)
+            {
+                if(i.second.state == Running)
+                {
+                    i.second.state = Stopped;
+                }
+            }
+        }
+        Inferior& inferior = get(number);
+        inferior.state = Stopped;
+        inferior.currentThread = thread.toInt();
+        inferior.lastStop = record;
+        ++inferior.stops;
+        return true;
+    }
+    return false;
+}
+
+void Inferiors::readGroups(const MiValue &groups)
+{   //take executables from reply of -list-thread-groups, notifications don't report them
+    /*
+        ^done,groups=[{id="i1",type="process",pid="1234",executable="/srv/server"},{id="i2",...}]
+    */
+    for(int i=0;i<groups.size();++i)
+    {
+        const MiValue& group = groups.at(i);
+        auto found = mInferiors.find(parseId(group["id"].getString()));
+        if(found != mInferiors.end())
+        {
+            found->second.executable = group["executable"].getString();
+        }
+    }
+}
+
+int Inferiors::findByThread(int thread) const
+{   //number of inferior of $thread$, 0 if thread is unknown
+    auto found = mThreadInferiors.find(thread);
+    return found == mThreadInferiors.end() ? 0 : found->second;
+}
+
+const Inferiors::Inferior *Inferiors::find(int number) const
+{
+    auto found = mInferiors.find(number);
+    return found == mInferiors.end() ? nullptr : &found->second;
+}
+
+const std::map<int, Inferiors::Inferior> &Inferiors::getInferiors() const
+{
+    return mInferiors;
+}
+
+int Inferiors::getFocus() const
+{
+    return mFocus;
+}
+
+bool Inferiors::setFocus(int number)
+{
+    if(mInferiors.count(number) == 0)
+    {
+        return false;
+    }
+    mFocus = number;
+    return true;
+}
+
+int Inferiors::parseId(const QString &id)
+{   //"i2" to 2
+    return id.mid(1).toInt();
+}
+
+Inferiors::Inferior &Inferiors::get(int number)
+{
+    Inferior& inferior = mInferiors[number];
+    inferior.number = number;
+    return inferior;
+}
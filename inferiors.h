@@ -0,0 +1,48 @@
+#ifndef INFERIORS_H
+#define INFERIORS_H
+
+#include <QString>
+
+#include <map>
+#include <set>
+
+#include "mirecord.h"
+
+/* Processes GDB debugs, built from =thread-group-* and =thread-* notifications. GDB numbers threads
+   across all inferiors, so thread id of *stopped and *running tells which inferior they belong to */
+
+class Inferiors
+{
+public:
+    enum State{NotStarted, Running, Stopped, Exited};
+    struct Inferior
+    {
+        int number;             // N of thread group "iN"
+        qint64 pid = 0;
+        QString executable;
+        State state = NotStarted;
+        QString exitCode;
+        std::set<int> threads;
+        int stops = 0;
+        int currentThread = 0;  // thread of the last stop, selected when inferior gets focus
+        MiRecord lastStop;      // views of inferior are refreshed from it when it gets focus
+    };
+
+    Inferiors();
+    bool read(const MiRecord& record);
+    void readGroups(const MiValue& groups);
+    int findByThread(int thread)const;
+    const Inferior* find(int number)const;
+    const std::map<int, Inferior>& getInferiors()const;
+    int getFocus()const;
+    bool setFocus(int number);
+    static int parseId(const QString& id);
+private:
+    Inferior& get(int number);
+
+    std::map<int, Inferior> mInferiors;
+    std::map<int, int> mThreadInferiors;    // thread id to inferior number
+    int mFocus;                             // inferior shown in views
+};
+
+#endif // INFERIORS_H
@@ -0,0 +1,149 @@
+#include "inferiorterminal.h"
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+static const int capacity = 4*1024*1024;   // bytes waiting for GUI, older output is dropped
+static const int chunkSize = 64*1024;
+
+InferiorTerminal::InferiorTerminal(QObject *parent):
+    QObject(parent),
+    mMaster{-1},
+    mSlave{-1},
+    mStop{false},
+    mTotal{0},
+    mDropped{0}
+{
+}
+
+InferiorTerminal::~InferiorTerminal()
+{
+    close();
+}
+
+bool InferiorTerminal::open()
+{   //create terminal and start reading it. Name of terminal is passed to GDB by -inferior-tty-set.
+    //Returns false where there are no pseudo terminals, program gets its own console there
+#ifdef Q_OS_UNIX
+    if(isOpen())
+    {
+        return true;
+    }
+    mMaster = ::posix_openpt(O_RDWR | O_NOCTTY);
+    if(mMaster == -1 || ::grantpt(mMaster) != 0 || ::unlockpt(mMaster) != 0)
+    {
+        close();
+        return false;
+    }
+    mTtyName = QString::fromLocal8Bit(::ptsname(mMaster));
+    mSlave = ::open(mTtyName.toLocal8Bit().constData(), O_RDWR | O_NOCTTY);
+    if(mSlave == -1)
+    {
+        close();
+        return false;
+    }
+    termios settings;
+    if(::tcgetattr(mSlave, &settings) == 0)
+    {   // no echo and no "\n" to "\r\n" translation
+        ::cfmakeraw(&settings);
+        ::tcsetattr(mSlave, TCSANOW, &settings);
+    }
+    mStop = false;
+    mReader = std::thread(&InferiorTerminal::readLoop, this);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void InferiorTerminal::close()
+{
+    mStop = true;
+    if(mReader.joinable())
+    {
+        mReader.join();
+    }
+#ifdef Q_OS_UNIX
+    if(mSlave != -1)
+    {
+        ::close(mSlave);
+    }
+    if(mMaster != -1)
+    {
+        ::close(mMaster);
+    }
+#endif
+    mSlave = -1;
+    mMaster = -1;
+    mTtyName.clear();
+}
+
+bool InferiorTerminal::isOpen() const
+{
+    return mMaster != -1;
+}
+
+const QString &InferiorTerminal::getTtyName() const
+{
+    return mTtyName;
+}
+
+QByteArray InferiorTerminal::takeOutput()
+{   //output which came since the last call
+    std::lock_guard<std::mutex> lock(mMutex);
+    QByteArray output;
+    output.swap(mPending);
+    return output;
+}
+
+qint64 InferiorTerminal::getTotalBytes() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mTotal;
+}
+
+qint64 InferiorTerminal::getDroppedBytes() const
+{   //output dropped because GUI didn't keep up
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mDropped;
+}
+
+int InferiorTerminal::getCapacity()
+{
+    return capacity;
+}
+
+void InferiorTerminal::readLoop()
+{   //runs in reader thread. Waits with timeout, so close() doesn't hang on blocked read
+#ifdef Q_OS_UNIX
+    QByteArray chunk(chunkSize, Qt::Uninitialized);
+    while(!mStop)
+    {
+        pollfd descriptor{mMaster, POLLIN, 0};
+        int ready = ::poll(&descriptor, 1, 100);
+        if(ready <= 0 || (descriptor.revents & POLLIN) == 0)
+        {
+            continue;
+        }
+        ssize_t size = ::read(mMaster, chunk.data(), chunkSize);
+        if(size <= 0)
+        {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTotal += size;
+        mPending.append(chunk.constData(), static_cast<int>(size));
+        if(mPending.size() > capacity)
+        {   // drop a quarter more than needed, so buffer isn't moved on every chunk
+            int excess = mPending.size() - capacity + capacity/4;
+            mPending.remove(0, excess);
+            mDropped += excess;
+        }
+    }
+#endif
+}
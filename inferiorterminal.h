@@ -0,0 +1,42 @@
+#ifndef INFERIORTERMINAL_H
+#define INFERIORTERMINAL_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+class InferiorTerminal : public QObject
+{   // pseudo terminal for output of debugged program, so it never mixes with MI records.
+    // Reader thread collects output into bounded buffer, GUI takes it by timer
+    Q_OBJECT
+public:
+    explicit InferiorTerminal(QObject* parent = 0);
+    ~InferiorTerminal();
+    bool open();
+    void close();
+    bool isOpen()const;
+    const QString& getTtyName()const;
+    QByteArray takeOutput();
+    qint64 getTotalBytes()const;
+    qint64 getDroppedBytes()const;
+    static int getCapacity();
+
+private:
+    void readLoop();
+
+    int mMaster;
+    int mSlave;     // kept open, so master doesn't get EOF each time program closes terminal
+    QString mTtyName;
+    std::thread mReader;
+    std::atomic<bool> mStop;
+    mutable std::mutex mMutex;
+    QByteArray mPending;    // output GUI didn't take yet, guarded by mMutex
+    qint64 mTotal;
+    qint64 mDropped;
+};
+
+#endif // INFERIORTERMINAL_H
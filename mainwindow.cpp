@@ -1,20 +1,103 @@
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
+#include "statesnapshot.h"
 
 #include <QProcess>
 #include <QDebug>
 #include <QTextStream>
 #include <QMessageBox>
+#include <QHeaderView>
+#include <QScrollBar>
+#include <QFileInfo>
+#include <QStatusBar>
+#include <QTextCodec>
+#include <QTextDecoder>
+#include <QDateTime>
+#include <QToolTip>
 
 #include <algorithm>
+#include <map>
+
+enum WatchRole{IdRole = Qt::UserRole, VarObjectRole, FetchedRole, TotalRole, DisplayHintRole, MoreRole};
+enum LargeValueRole{FieldStartRole = Qt::UserRole, FieldValueRole, FieldEndRole};
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
     ui(new Ui::MainWindow),
-    mProcess{new Gdb("debug/gdbx64/bin/gdb.exe")}
+    mProcess{new Gdb("debug/gdbx64/bin/gdb.exe")},
+    mBreakpointsChanged{false},
+    mWatchList{new WatchList(mProcess, this)},
+    mRegisters{new Registers(mProcess, this)},
+    mDisassembly{new Disassembly(mProcess, this)},
+    mShownFunction{0},
+    mStartup{new Startup(mProcess, this)},
+    mSymbolIndex{new SymbolIndex(mProcess, this)},
+    mCoreSnapshot{new CoreSnapshot(mProcess, this)},
+    mTerminal{new InferiorTerminal(this)},
+    mOutputDecoder{QTextCodec::codecForName("UTF-8")->makeDecoder()},
+    mSessionPosition{0},
+    mSessionShown{0},
+    mWatchHistoryChanged{false},
+    mStopCount{0},
+    mStopTimeTotal{0},
+    mStopTimeMax{0},
+    mTimeTravel{new TimeTravel(mProcess, this)},
+    mEvaluator{new Evaluator(mProcess, this)},
+    mInferiorsChanged{false}
 {
     ui->setupUi(this);
 
+    /* the whole session goes to log file, Session tab searches it by chunks of time
+       from timer, so GUI stays responsive with millions of records */
+    SessionLog::removeOldSessions(SessionLog::getDefaultDir());
+    QString sessionFile = QString("%1/session-%2.log").arg(SessionLog::getDefaultDir())
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+    if(!mSessionLog.open(sessionFile))
+    {
+        ui->designOutput->appendPlainText(tr("Can't write session log %1").arg(sessionFile));
+    }
+    mProcess->setSessionLog(&mSessionLog);
+    ui->sessionKind->addItem(tr("All"), (1u << SessionLog::KindCount) - 1);
+    for(int i = 0; i < SessionLog::KindCount; ++i)
+    {
+        ui->sessionKind->addItem(SessionLog::getKindName(i), 1u << i);
+    }
+    ui->sessionTime->setTime(QTime::currentTime());
+    mSessionSearchTimer.setSingleShot(true);
+    connect(&mSessionSearchTimer, SIGNAL(timeout()), this, SLOT(slotContinueSessionSearch()), Qt::UniqueConnection);
+    connect(ui->butSessionSearch, SIGNAL(clicked(bool)), this, SLOT(slotSearchSession()), Qt::UniqueConnection);
+    connect(ui->sessionPattern, SIGNAL(returnPressed()), this, SLOT(slotSearchSession()), Qt::UniqueConnection);
+    connect(ui->butSessionJump, SIGNAL(clicked(bool)), this, SLOT(slotJumpSessionTime()), Qt::UniqueConnection);
+    connect(ui->butSessionMore, SIGNAL(clicked(bool)), this, SLOT(slotMoreSession()), Qt::UniqueConnection);
+    connect(ui->butInsertWatchpoint, SIGNAL(clicked(bool)), this, SLOT(slotInsertWatchpoint()), Qt::UniqueConnection);
+    connect(ui->butClearWatchHistory, SIGNAL(clicked(bool)), this, SLOT(slotClearWatchHistory()), Qt::UniqueConnection);
+    connect(mProcess, SIGNAL(signalWatchHistoryChanged()), this, SLOT(slotWatchHistoryChanged()), Qt::UniqueConnection);
+    connect(&mRefreshTimer, SIGNAL(timeout()), this, SLOT(slotRefreshWatchHistory()), Qt::UniqueConnection);
+    connect(ui->butConnectRemote, SIGNAL(clicked(bool)), this, SLOT(slotConnectRemote()), Qt::UniqueConnection);
+    connect(mProcess, SIGNAL(signalStopSettled(qint64,int)), this, SLOT(slotStopSettled(qint64,int)), Qt::UniqueConnection);
+    connect(ui->butReverseStep, SIGNAL(clicked(bool)), this, SLOT(slotReverseStep()), Qt::UniqueConnection);
+    connect(ui->butReverseNext, SIGNAL(clicked(bool)), this, SLOT(slotReverseNext()), Qt::UniqueConnection);
+    connect(ui->butReverseFinish, SIGNAL(clicked(bool)), this, SLOT(slotReverseFinish()), Qt::UniqueConnection);
+    connect(ui->butReverseContinue, SIGNAL(clicked(bool)), this, SLOT(slotReverseContinue()), Qt::UniqueConnection);
+    connect(ui->butStartTimeTravel, SIGNAL(clicked(bool)), this, SLOT(slotStartTimeTravel()), Qt::UniqueConnection);
+    connect(ui->butStopTimeTravel, SIGNAL(clicked(bool)), this, SLOT(slotStopTimeTravel()), Qt::UniqueConnection);
+    connect(ui->butGoToPresent, SIGNAL(clicked(bool)), this, SLOT(slotGoToPresent()), Qt::UniqueConnection);
+    connect(ui->ttMarksView, SIGNAL(itemDoubleClicked(QTreeWidgetItem*,int)), this, SLOT(slotTimeMarkActivated(QTreeWidgetItem*)), Qt::UniqueConnection);
+    connect(mTimeTravel, SIGNAL(signalChanged()), this, SLOT(slotTimeTravelChanged()), Qt::UniqueConnection);
+    connect(mTimeTravel, SIGNAL(signalRewound(MiRecord)), this, SLOT(slotShowStopLocation(MiRecord)), Qt::UniqueConnection);
+    slotTimeTravelChanged();
+    connect(ui->sourceView, SIGNAL(signalHover(QString,QPoint)), this, SLOT(slotSourceHover(QString,QPoint)), Qt::UniqueConnection);
+    connect(ui->quickEvalExpression, SIGNAL(returnPressed()), this, SLOT(slotQuickEval()), Qt::UniqueConnection);
+    connect(ui->butQuickEval, SIGNAL(clicked(bool)), this, SLOT(slotQuickEval()), Qt::UniqueConnection);
+    connect(mEvaluator, SIGNAL(signalEvaluated(QString,Evaluator::Result)),
+            this, SLOT(slotEvaluated(QString,Evaluator::Result)), Qt::UniqueConnection);
+    connect(ui->butApplyForkPolicy, SIGNAL(clicked(bool)), this, SLOT(slotApplyForkPolicy()), Qt::UniqueConnection);
+    connect(ui->inferiorsFollowStops, SIGNAL(toggled(bool)), this, SLOT(slotFollowStopsToggled(bool)), Qt::UniqueConnection);
+    connect(ui->inferiorsView, SIGNAL(itemDoubleClicked(QTreeWidgetItem*,int)), this, SLOT(slotInferiorActivated(QTreeWidgetItem*)), Qt::UniqueConnection);
+    connect(mProcess, SIGNAL(signalInferiorsChanged()), this, SLOT(slotInferiorsChanged()), Qt::UniqueConnection);
+    connect(mProcess, SIGNAL(signalFocusChanged(MiRecord)), this, SLOT(slotShowStopLocation(MiRecord)), Qt::UniqueConnection);
+    connect(&mRefreshTimer, SIGNAL(timeout()), this, SLOT(slotRefreshInferiors()), Qt::UniqueConnection);
+
     connect(mProcess, SIGNAL(signalReadyReadGdb()), this, SLOT(slotReadOutput()), Qt::UniqueConnection);
     connect(mProcess, SIGNAL(signalErrorOccured(QString)), this, SLOT(slotErrorOccured(QString)), Qt::UniqueConnection);
     connect(mProcess, SIGNAL(signalLocalVarRecieved(QString)), this, SLOT(slotReadLocalVar(QString)), Qt::UniqueConnection);
@@ -42,24 +125,91 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(mProcess, SIGNAL(signalTypeUpdated(Variable)), this, SLOT(slotTypeUpdated(Variable)), Qt::UniqueConnection);
     connect(mProcess, SIGNAL(signalContentUpdated(Variable)), this, SLOT(slotDereferenceVar(Variable)), Qt::UniqueConnection);
     connect(mProcess, SIGNAL(signalBreakpointHit(int)), this, SLOT(slotBreakpointHit(int)), Qt::UniqueConnection);
+    connect(ui->butAddLogpoint, SIGNAL(clicked(bool)), this, SLOT(slotAddLogpoint()), Qt::UniqueConnection);
+    connect(ui->butRemoveLogpoint, SIGNAL(clicked(bool)), this, SLOT(slotRemoveLogpoint()), Qt::UniqueConnection);
+    connect(ui->butClearHitLog, SIGNAL(clicked(bool)), this, SLOT(slotClearHitLog()), Qt::UniqueConnection);
+    connect(ui->butInsertBreakpoint, SIGNAL(clicked(bool)), this, SLOT(slotInsertBreakpoint()), Qt::UniqueConnection);
+    connect(mProcess, SIGNAL(signalBreakpointsChanged()), this, SLOT(slotBreakpointsChanged()), Qt::UniqueConnection);
+    connect(ui->butAddWatch, SIGNAL(clicked(bool)), this, SLOT(slotAddWatch()), Qt::UniqueConnection);
+    connect(ui->watchExpression, SIGNAL(returnPressed()), this, SLOT(slotAddWatch()), Qt::UniqueConnection);
+    connect(ui->butRemoveWatch, SIGNAL(clicked(bool)), this, SLOT(slotRemoveWatch()), Qt::UniqueConnection);
+    connect(mWatchList, SIGNAL(signalWatchChanged(int)), this, SLOT(slotWatchChanged(int)), Qt::UniqueConnection);
+    connect(mWatchList, SIGNAL(signalChildrenFetched(QString,int,std::vector<VarChild>,bool)),
+            this, SLOT(slotWatchChildrenFetched(QString,int,std::vector<VarChild>,bool)), Qt::UniqueConnection);
+    connect(mWatchList, SIGNAL(signalVarObjectChanged(QString,QString,bool)),
+            this, SLOT(slotVarObjectChanged(QString,QString,bool)), Qt::UniqueConnection);
+    connect(mWatchList, SIGNAL(signalChildrenReset(QString)), this, SLOT(slotVarObjectChildrenReset(QString)), Qt::UniqueConnection);
+    connect(ui->watchView, SIGNAL(itemExpanded(QTreeWidgetItem*)), this, SLOT(slotWatchExpanded(QTreeWidgetItem*)), Qt::UniqueConnection);
+    connect(ui->watchView, SIGNAL(itemCollapsed(QTreeWidgetItem*)), this, SLOT(slotWatchCollapsed(QTreeWidgetItem*)), Qt::UniqueConnection);
+    connect(ui->watchView, SIGNAL(itemDoubleClicked(QTreeWidgetItem*,int)), this, SLOT(slotWatchActivated(QTreeWidgetItem*)), Qt::UniqueConnection);
+    connect(ui->butWalk, SIGNAL(clicked(bool)), this, SLOT(slotWalkStructure()), Qt::UniqueConnection);
+    connect(mProcess, SIGNAL(signalStructureWalked(StructureWalk)), this, SLOT(slotStructureWalked(StructureWalk)), Qt::UniqueConnection);
+    connect(mRegisters, SIGNAL(signalNamesRecieved()), this, SLOT(slotRegisterNamesRecieved()), Qt::UniqueConnection);
+    connect(mRegisters, SIGNAL(signalRegistersChanged(std::vector<int>)), this, SLOT(slotRegistersChanged(std::vector<int>)), Qt::UniqueConnection);
+    connect(mDisassembly, SIGNAL(signalDisassembled(quint64)), this, SLOT(slotDisassembled(quint64)), Qt::UniqueConnection);
+    connect(ui->disasmSource, SIGNAL(toggled(bool)), this, SLOT(slotDisassemblySourceToggled(bool)), Qt::UniqueConnection);
+    connect(ui->butOpenSource, SIGNAL(clicked(bool)), this, SLOT(slotOpenSource()), Qt::UniqueConnection);
+    connect(ui->sourcePath, SIGNAL(returnPressed()), this, SLOT(slotOpenSource()), Qt::UniqueConnection);
+    connect(ui->sourceView, SIGNAL(signalGutterClicked(int)), this, SLOT(slotSourceGutterClicked(int)), Qt::UniqueConnection);
+    connect(mProcess, SIGNAL(signalStopped(MiRecord)), this, SLOT(slotShowStopLocation(MiRecord)), Qt::UniqueConnection);
+    connect(mProcess, SIGNAL(signalRunning()), this, SLOT(slotTargetRunning()), Qt::UniqueConnection);
+    connect(&mRefreshTimer, SIGNAL(timeout()), this, SLOT(slotRefreshHitLog()), Qt::UniqueConnection);
+    connect(&mRefreshTimer, SIGNAL(timeout()), this, SLOT(slotRefreshBreakpoints()), Qt::UniqueConnection);
+    connect(&mRefreshTimer, SIGNAL(timeout()), this, SLOT(slotRefreshInferiorOutput()), Qt::UniqueConnection);
+    connect(ui->butFindOutput, SIGNAL(clicked(bool)), this, SLOT(slotFindOutput()), Qt::UniqueConnection);
+    connect(ui->outputSearch, SIGNAL(returnPressed()), this, SLOT(slotFindOutput()), Qt::UniqueConnection);
+    connect(ui->butClearOutput, SIGNAL(clicked(bool)), this, SLOT(slotClearOutput()), Qt::UniqueConnection);
+
+    /* Logpoints and ignored breakpoint hits may come millions of times, so views are refreshed
+       by timer instead of signal per hit and echo keeps only the last lines */
+    ui->echo->setMaximumBlockCount(10000);
+    ui->inferiorOutput->setMaximumBlockCount(20000);
+    mHitLogModel = new HitLogModel(mProcess->getHitLog(), this);
+    ui->hitLogView->setModel(mHitLogModel);
+    ui->hitLogView->horizontalHeader()->setStretchLastSection(true);
+    ui->hitLogView->verticalHeader()->setVisible(false);
+    ui->hitLogView->verticalHeader()->setDefaultSectionSize(ui->hitLogView->fontMetrics().height() + 4);
+    mRefreshTimer.start(200);
+    connect(mStartup, SIGNAL(signalProgress(QString)), this, SLOT(slotStartupProgress(QString)), Qt::UniqueConnection);
+    connect(mStartup, SIGNAL(signalFailed(QString)), this, SLOT(slotStartupFailed(QString)), Qt::UniqueConnection);
+    connect(mStartup, SIGNAL(signalFinished(qint64)), this, SLOT(slotStartupFinished()), Qt::UniqueConnection);
+    connect(mSymbolIndex, SIGNAL(signalProgress(QString)), this, SLOT(slotSymbolIndexProgress(QString)), Qt::UniqueConnection);
+    connect(mSymbolIndex, SIGNAL(signalReady(int)), this, SLOT(slotSearchSymbols()), Qt::UniqueConnection);
+    connect(ui->symbolQuery, SIGNAL(textChanged(QString)), this, SLOT(slotSearchSymbols()), Qt::UniqueConnection);
+    connect(ui->symbolsView, SIGNAL(itemDoubleClicked(QTreeWidgetItem*,int)), this, SLOT(slotSymbolActivated(QTreeWidgetItem*)), Qt::UniqueConnection);
+    connect(ui->butSymbolBreakpoint, SIGNAL(clicked(bool)), this, SLOT(slotSymbolBreakpoint()), Qt::UniqueConnection);
+    connect(ui->butOpenCore, SIGNAL(clicked(bool)), this, SLOT(slotOpenCore()), Qt::UniqueConnection);
+    connect(ui->butCaptureSnapshot, SIGNAL(clicked(bool)), this, SLOT(slotCaptureSnapshot()), Qt::UniqueConnection);
+    connect(mCoreSnapshot, SIGNAL(signalProgress(QString)), this, SLOT(slotCoreProgress(QString)), Qt::UniqueConnection);
+    connect(mCoreSnapshot, SIGNAL(signalCaptured(qint64)), this, SLOT(slotSnapshotCaptured()), Qt::UniqueConnection);
+    connect(ui->coreThreadsView, SIGNAL(currentItemChanged(QTreeWidgetItem*,QTreeWidgetItem*)),
+            this, SLOT(slotSnapshotFrameSelected(QTreeWidgetItem*)), Qt::UniqueConnection);
+    connect(ui->butSaveState, SIGNAL(clicked(bool)), this, SLOT(slotSaveState()), Qt::UniqueConnection);
+    connect(ui->butCancelPrint, SIGNAL(clicked(bool)), this, SLOT(slotCancelPrint()), Qt::UniqueConnection);
+    connect(mProcess, SIGNAL(signalPrintProgress(QString,qint64)), this, SLOT(slotPrintProgress(QString,qint64)), Qt::UniqueConnection);
+    connect(mProcess, SIGNAL(signalLargeContentCaptured(PrintCapturePtr)), this, SLOT(slotLargeContentCaptured(PrintCapturePtr)), Qt::UniqueConnection);
+    connect(ui->butDiffStates, SIGNAL(clicked(bool)), this, SLOT(slotDiffStates()), Qt::UniqueConnection);
     QFile file(qApp->applicationDirPath().append("/gdb/gdb.exe"));
 //    qDebug() << "File exist: " << (file.exists());
-    mProcess->start(QStringList() << "--interpreter=mi");
 
 //    ui->command->setText("target exec debug/gdbx64/main.exe");
-    mProcess->openProject("debug/gdbx64/pairs.exe");
-    mProcess->setBreakPoint(19);
-    mProcess->run();
+    if(mTerminal->open())
+    {   // program output goes to own terminal instead of GDB pipe with MI records
+        mStartup->setInferiorTty(mTerminal->getTtyName());
+    }
+    mStartup->start("debug/gdbx64/pairs.exe", QStringList() << "19");
     ui->command->setFocus();
     ui->treeWidget->setColumnCount(3);
 }
 
 MainWindow::~MainWindow()
 {
+    mProcess->setSessionLog(nullptr);
+    delete mOutputDecoder;
     delete ui;
 }
 
-void MainWindow::addTreeRoot(Variable var)
+void MainWindow::addTreeRoot(const Variable &var)
 {
     QTreeWidgetItem *treeItem = new QTreeWidgetItem(ui->treeWidget);
 
@@ -74,7 +224,7 @@ void MainWindow::addTreeRoot(Variable var)
     addTreeChildren(treeItem, var, "");
 }
 
-void MainWindow::addTreeChild(QTreeWidgetItem *parent, Variable var, QString prefix, bool internal = false)
+void MainWindow::addTreeChild(QTreeWidgetItem *parent, const Variable &var, const QString &prefix, bool internal = false)
 {
     QTreeWidgetItem *treeItem = new QTreeWidgetItem();
     mTypeVar[var] = treeItem;
@@ -84,7 +234,7 @@ void MainWindow::addTreeChild(QTreeWidgetItem *parent, Variable var, QString pre
     }
 
 
-    QString plainName = var.getName().split('.').last();
+    QString plainName = var.getLeafName().split('.').last();
     treeItem->setText(0, plainName);
     treeItem->setText(1, var.getContent());
     treeItem->setText(2, var.getType());
@@ -99,7 +249,7 @@ void MainWindow::addTreeChild(QTreeWidgetItem *parent, Variable var, QString pre
     parent->addChild(treeItem);
 }
 
-void MainWindow::addTreeChildren(QTreeWidgetItem *parrent, Variable var, QString prefix, bool drfPointer)
+void MainWindow::addTreeChildren(QTreeWidgetItem *parrent, const Variable &var, const QString &prefix, bool drfPointer)
 {
     std::vector<Variable> nestedTypes = var.getNestedTypes();
     if(drfPointer && nestedTypes.size() ==0)
@@ -112,7 +262,7 @@ void MainWindow::addTreeChildren(QTreeWidgetItem *parrent, Variable var, QString
         addTreeChild(parrent, var, "", true);   //create fake node to enable expanding parent
         mPointersName[parrent] = var;   //Add pointer's node to map and attach to this node pointer
     }
-    for(auto i : nestedTypes)
+    for(const Variable& i : nestedTypes)
     {
     //        throw;
     //        QString likelyType;/* = mProcess->getVarType(i.getName());*/
@@ -141,14 +291,8 @@ void MainWindow::slotReadOutput()
 }
 
 void MainWindow::slotWriteToProcess()
-{
-    QByteArray data;
-//    data.append(ui->command->text());
-//    data.append('\n');
-    QByteArray enter("\n");
-    data.append(ui->command->text());
-    //data.append(enter);
-    mProcess->write(data);
+{   // typed commands go ahead of refreshes waiting in scheduler
+    mProcess->sendCommand(ui->command->text());
 
     ui->command->clear();
 }
@@ -176,22 +320,36 @@ void MainWindow::slotReadLocalVar(const QString &str)
 
 void MainWindow::slotRun()
 {
+    logEvent("run");
     mProcess->run();
 }
 
 void MainWindow::slotStepOver()
 {
+    logEvent("step over");
     mProcess->stepOver();
 }
 
 void MainWindow::slotSetBreakPoint()
-{
-    mProcess->setBreakPoint(9);
+{   // set breakpoint at line selected in source view
+    int line = ui->sourceView->getSelectedLine();
+    if(line == 0)
+    {
+        return;
+    }
+    mProcess->insertBreakpoint(QString("%1:%2").arg(ui->sourceView->getFileName()).arg(line));
 }
 
 void MainWindow::slotClearBreakPoint()
-{
-    mProcess->clearBreakPoint(40);
+{   // delete breakpoints at line selected in source view
+    int line = ui->sourceView->getSelectedLine();
+    for(const Breakpoint& i : mProcess->getBreakpoints())
+    {
+        if(i.getLine() == line && isSourceFile(i.getFile()))
+        {
+            mProcess->deleteBreakpoint(i.getNumber());
+        }
+    }
 }
 
 void MainWindow::slotStepIn()
@@ -215,7 +373,8 @@ void MainWindow::slotShowBreakpoints()
     auto brkLst = mProcess->getBreakpoints();
     for(Breakpoint i : brkLst)
     {
-        QString disposition = (i.getDisposition() == Breakpoint::Disposition::Keep) ? "Keep" : "Delete";
+        QString disposition = i.getDisposition() == Breakpoint::Disposition::Keep ? "Keep"
+                            : i.getDisposition() == Breakpoint::Disposition::Disable ? "Disable" : "Delete";
         ui->designOutput->appendPlainText(QString("Breakpoint. Disposition: %1 Function: %2 Line: %3 Enabled %4\n").arg(disposition)
                                   .arg(i.getFrame()).arg(QString::number(i.getLine()))
                                   .arg(i.isEnabled() ? "True" : "False"));
@@ -244,27 +403,29 @@ void MainWindow::slotUpdtaeLocals()
 void MainWindow::slotShowVariables()
 {
     ui->designOutput->clear();
-    auto locals = mProcess->getLocalVariables();
+    const std::vector<Variable>& locals = mProcess->getLocalVariables();
     ui->treeWidget->clear();
-    for(auto i : locals)
+    mLargeValues.clear();
+    for(const Variable& i : locals)
     {
         addTreeRoot(i);
     }
 }
 
-void MainWindow::slotTypeUpdated(Variable var)
+void MainWindow::slotTypeUpdated(const Variable &updated)
 {
+    Variable var = updated;
     auto iterator = (find_if(mPointersContent.begin(), mPointersContent.end(),
                                     [&](auto item)
                             {
-                                return (var.getName() == item.first.getName());
+                                return (var.getNameId() == item.first.getNameId());
                             }));
     if(iterator != mPointersContent.end())
     {
         QTreeWidgetItem* itemPointer = (find_if(mPointersContent.begin(), mPointersContent.end(),
                                     [&](auto item)
                             {
-                                return (var.getName() == item.first.getName());
+                                return (var.getNameId() == item.first.getNameId());
                             })->second);
         if(var.isPointer())
         {
@@ -295,7 +456,7 @@ void MainWindow::slotTypeUpdated(Variable var)
 
 }
 
-void MainWindow::slotDereferenceVar(Variable var)
+void MainWindow::slotDereferenceVar(const Variable &var)
 {
     mProcess->getVarType(var);
 }
@@ -310,6 +471,7 @@ void MainWindow::slotBreakpointHit(int line)
 
 void MainWindow::slotErrorOccured(QString error)
 {
+    mSessionLog.append(SessionLog::Error, error);
     ui->designOutput->appendPlainText(error);
 }
 
@@ -347,6 +509,29 @@ void MainWindow::slotItemExpanded(QTreeWidgetItem *item)
             moidifyTreeItemPointer(item);
             mPointersName.erase(foundIterator);
     }
+    if(item->childCount() == 0 && item->data(0, FieldStartRole).isValid())
+    {   // field of large value, its items are read from capture now
+        const qint64 expandLimit = 4*1024*1024; // characters
+        QTreeWidgetItem* root = item;
+        while(root != nullptr && mLargeValues.count(root) == 0)
+        {
+            root = root->parent();
+        }
+        if(root == nullptr)
+        {
+            return;
+        }
+        const PrintCapture& capture = *mLargeValues[root];
+        PrintCapture::Field field{item->data(0, FieldStartRole).toLongLong(), item->data(0, FieldValueRole).toLongLong(),
+                                  item->data(0, FieldEndRole).toLongLong()};
+        std::vector<PrintCapture::Field> fields = capture.readFields(field, expandLimit);
+        if(fields.empty())
+        {
+            new QTreeWidgetItem(item, QStringList() << QString() << tr("<value is too large to expand>"));
+            return;
+        }
+        addLargeValueFields(item, capture, fields);
+    }
 }
 
 void MainWindow::slotContinue()
@@ -363,3 +548,1238 @@ void MainWindow::slotStipExecuting()
 {
     mProcess->stopExecuting();
 }
+
+void MainWindow::slotAddLogpoint()
+{
+    QString location = ui->logLocation->text().trimmed();
+    if(location.isEmpty())
+    {
+        return;
+    }
+    mProcess->setLogpoint(location, ui->logFormat->text(), ui->logArguments->text());
+}
+
+void MainWindow::slotRemoveLogpoint()
+{
+    QTreeWidgetItem* item = ui->logpointStats->currentItem();
+    if(item == nullptr)
+    {
+        return;
+    }
+    int id = item->text(0).toInt();
+    mProcess->removeLogpoint(id);
+    mLogpointItems.erase(id);
+    delete item;
+}
+
+void MainWindow::slotClearHitLog()
+{
+    mProcess->clearHitLog();
+    slotRefreshHitLog();
+}
+
+void MainWindow::slotRefreshHitLog()
+{   // update hit log view and logpoint counters once per timer tick
+    QScrollBar* scroll = ui->hitLogView->verticalScrollBar();
+    bool atBottom = scroll->value() == scroll->maximum();
+    mHitLogModel->refresh();
+    if(atBottom)
+    {
+        ui->hitLogView->scrollToBottom();
+    }
+
+    const HitLog& log = mProcess->getHitLog();
+    for(const auto& i : mProcess->getLogpoints())
+    {
+        QTreeWidgetItem*& item = mLogpointItems[i.first];
+        if(item == nullptr)
+        {
+            item = new QTreeWidgetItem(ui->logpointStats);
+            item->setText(0, QString::number(i.first));
+            item->setText(1, i.second.location);
+        }
+        auto stats = log.getStats().find(i.first);
+        qint64 count = stats == log.getStats().end() ? 0 : stats->second.count;
+        item->setText(2, QString::number(count));
+        item->setText(3, QString::number(log.getRate(i.first), 'f', 1));
+    }
+}
+
+void MainWindow::slotInsertBreakpoint()
+{
+    QString location = ui->brkLocation->text().trimmed();
+    if(location.isEmpty())
+    {
+        return;
+    }
+    int thread = ui->brkThread->value() == 0 ? -1 : ui->brkThread->value();
+    int inferior = ui->brkInferiorOnly->isChecked() ? mProcess->getInferiors().getFocus() : 0;
+    logEvent(QString("insert breakpoint %1").arg(location));
+    mProcess->insertBreakpoint(location, ui->brkCondition->text(), ui->brkIgnore->value(),
+                               thread, ui->brkHitLimit->value(), inferior);
+}
+
+void MainWindow::slotBreakpointsChanged()
+{   // called on every hit count update, table is redrawn by timer
+    mBreakpointsChanged = true;
+}
+
+void MainWindow::slotRefreshBreakpoints()
+{
+    if(!mBreakpointsChanged)
+    {
+        return;
+    }
+    mBreakpointsChanged = false;
+    const std::vector<Breakpoint>& breakpoints = mProcess->getBreakpoints();
+    QTreeWidget* view = ui->breakpointsView;
+    while(view->topLevelItemCount() > static_cast<int>(breakpoints.size()))
+    {
+        delete view->takeTopLevelItem(view->topLevelItemCount()-1);
+    }
+    for(size_t i=0;i<breakpoints.size();++i)
+    {
+        const Breakpoint& brk = breakpoints[i];
+        QTreeWidgetItem* item = view->topLevelItem(static_cast<int>(i));
+        if(item == nullptr)
+        {
+            item = new QTreeWidgetItem(view);
+        }
+        item->setText(0, QString::number(brk.getNumber()));
+        item->setText(1, brk.getLocation());
+        item->setText(2, brk.getCondition());
+        item->setText(3, QString::number(brk.getIgnoreCount()));
+        item->setText(4, brk.getThread() == -1 ? tr("Any") : QString::number(brk.getThread()));
+        item->setText(5, QString::number(brk.getHitCount()));
+        item->setText(6, brk.getHitLimit() == 0 ? QString() : QString::number(brk.getHitLimit()));
+        item->setText(7, brk.isEnabled() ? tr("Yes") : tr("No"));
+        item->setText(8, brk.getThreadGroups().join(", "));
+    }
+    updateSourceBreakpoints();
+}
+
+void MainWindow::slotAddWatch()
+{
+    QString expression = ui->watchExpression->text().trimmed();
+    if(expression.isEmpty())
+    {
+        return;
+    }
+    logEvent(QString("add watch %1").arg(expression));
+    int id = mWatchList->addWatch(expression);
+    QTreeWidgetItem* item = new QTreeWidgetItem(ui->watchView);
+    item->setText(0, expression);
+    item->setData(0, IdRole, id);
+    mWatchItems[id] = item;
+    ui->watchExpression->clear();
+}
+
+void MainWindow::slotRemoveWatch()
+{
+    QTreeWidgetItem* item = ui->watchView->currentItem();
+    if(item == nullptr || item->parent() != nullptr)
+    {
+        return;
+    }
+    int id = item->data(0, IdRole).toInt();
+    mWatchList->removeWatch(id);
+    mWatchItems.erase(id);
+    forgetVarObjectChildren(item);
+    mVarObjectItems.erase(item->data(0, VarObjectRole).toString());
+    delete item;
+}
+
+void MainWindow::slotWatchChanged(int id)
+{   // redraw only the row of changed watch
+    auto item = mWatchItems.find(id);
+    auto watch = mWatchList->getWatches().find(id);
+    if(item == mWatchItems.end() || watch == mWatchList->getWatches().end())
+    {
+        return;
+    }
+    QTreeWidgetItem* watchItem = item->second;
+    const Watch& info = watch->second;
+    watchItem->setText(1, info.value);
+    watchItem->setText(2, info.type);
+    watchItem->setDisabled(!info.inScope);
+    QString oldVarObject = watchItem->data(0, VarObjectRole).toString();
+    if(oldVarObject != info.varObject)
+    {   // variable object was created again, its old children are gone
+        forgetVarObjectChildren(watchItem);
+        mVarObjectItems.erase(oldVarObject);
+        watchItem->setData(0, FetchedRole, false);
+    }
+    setupVarObjectItem(watchItem, info.varObject, info.numChildren, info.dynamic, info.displayHint);
+}
+
+void MainWindow::setupVarObjectItem(QTreeWidgetItem *item, const QString &varObject, int numChildren,
+                                    bool dynamic, const QString &displayHint)
+{   // attach variable object to tree item. Children are listed only when item is expanded
+    item->setData(0, VarObjectRole, varObject);
+    item->setData(0, TotalRole, dynamic ? -1 : numChildren);
+    item->setData(0, DisplayHintRole, displayHint);
+    bool expandable = !varObject.isEmpty() && displayHint != "string" && (numChildren != 0 || dynamic);
+    item->setChildIndicatorPolicy(expandable ? QTreeWidgetItem::ShowIndicator
+                                             : QTreeWidgetItem::DontShowIndicatorWhenChildless);
+    if(!varObject.isEmpty())
+    {
+        mVarObjectItems[varObject] = item;
+    }
+}
+
+void MainWindow::forgetVarObjectChildren(QTreeWidgetItem *item)
+{   // delete children of $item$ and their variable object bindings
+    for(int i=0;i<item->childCount();++i)
+    {
+        QTreeWidgetItem* child = item->child(i);
+        forgetVarObjectChildren(child);
+        QString varObject = child->data(0, VarObjectRole).toString();
+        if(!varObject.isEmpty())
+        {
+            mVarObjectItems.erase(varObject);
+        }
+    }
+    qDeleteAll(item->takeChildren());
+}
+
+void MainWindow::slotWatchExpanded(QTreeWidgetItem *item)
+{   // the first window of children is listed on the first expand
+    QString varObject = item->data(0, VarObjectRole).toString();
+    if(varObject.isEmpty() || item->data(0, FetchedRole).toBool())
+    {
+        return;
+    }
+    item->setData(0, FetchedRole, true);
+    mWatchList->fetchChildren(varObject, 0, item->data(0, TotalRole).toInt());
+}
+
+void MainWindow::slotWatchCollapsed(QTreeWidgetItem *item)
+{   // children nobody looks at are dropped, they are listed again on the next expand
+    QString varObject = item->data(0, VarObjectRole).toString();
+    if(varObject.isEmpty() || !item->data(0, FetchedRole).toBool())
+    {
+        return;
+    }
+    mWatchList->dropChildren(varObject);
+    forgetVarObjectChildren(item);
+    item->setData(0, FetchedRole, false);
+}
+
+void MainWindow::slotWatchActivated(QTreeWidgetItem *item)
+{   // "more" node replaces shown window of children by the next one
+    QTreeWidgetItem* parent = item->parent();
+    if(parent == nullptr || !item->data(0, MoreRole).isValid())
+    {
+        return;
+    }
+    int from = item->data(0, MoreRole).toInt();
+    QString varObject = parent->data(0, VarObjectRole).toString();
+    mWatchList->dropChildren(varObject);
+    forgetVarObjectChildren(parent);
+    mWatchList->fetchChildren(varObject, from, parent->data(0, TotalRole).toInt());
+}
+
+void MainWindow::slotWatchChildrenFetched(const QString &varObject, int from,
+                                          const std::vector<VarChild> &children, bool hasMore)
+{
+    auto found = mVarObjectItems.find(varObject);
+    if(found == mVarObjectItems.end())
+    {
+        return;
+    }
+    QTreeWidgetItem* parent = found->second;
+    bool isMap = parent->data(0, DisplayHintRole).toString() == "map";
+    size_t step = isMap ? 2 : 1;
+    for(size_t i=0;i+step<=children.size();i+=step)
+    {   // map printers list key and value as two children, they are shown as one row
+        const VarChild& child = children[i+step-1];
+        QTreeWidgetItem* item = new QTreeWidgetItem(parent);
+        item->setText(0, isMap ? QString("[%1]").arg(children[i].value) : child.expression);
+        item->setText(1, child.value);
+        item->setText(2, child.type);
+        setupVarObjectItem(item, child.name, child.numChildren, child.dynamic, child.displayHint);
+    }
+    if(hasMore)
+    {
+        QTreeWidgetItem* more = new QTreeWidgetItem(parent);
+        more->setText(0, tr("... double click to show next"));
+        more->setData(0, MoreRole, from + static_cast<int>(children.size()));
+    }
+}
+
+void MainWindow::slotVarObjectChanged(const QString &varObject, const QString &value, bool inScope)
+{
+    auto found = mVarObjectItems.find(varObject);
+    if(found != mVarObjectItems.end())
+    {
+        found->second->setText(1, value);
+        found->second->setDisabled(!inScope);
+    }
+}
+
+void MainWindow::slotVarObjectChildrenReset(const QString &varObject)
+{   // container changed its size or type, children are listed again on the next expand
+    auto found = mVarObjectItems.find(varObject);
+    if(found == mVarObjectItems.end())
+    {
+        return;
+    }
+    QTreeWidgetItem* item = found->second;
+    if(item->data(0, FetchedRole).toBool())
+    {
+        mWatchList->dropChildren(varObject);
+    }
+    forgetVarObjectChildren(item);
+    item->setData(0, FetchedRole, false);
+    if(item->isExpanded())
+    {
+        item->setData(0, FetchedRole, true);
+        mWatchList->fetchChildren(varObject, 0, item->data(0, TotalRole).toInt());
+    }
+}
+
+void MainWindow::slotWalkStructure()
+{
+    QString root = ui->walkRoot->text().trimmed();
+    QStringList links = ui->walkLinks->text().split(',', QString::SkipEmptyParts);
+    if(root.isEmpty() || links.isEmpty())
+    {
+        return;
+    }
+    for(QString& i : links)
+    {
+        i = i.trimmed();
+    }
+    QStringList values = ui->walkValues->text().split(',', QString::SkipEmptyParts);
+    for(QString& i : values)
+    {
+        i = i.trimmed();
+    }
+    ui->walkStatus->setText(tr("Walking..."));
+    mProcess->walkStructure(root, links, values, ui->walkMax->value());
+}
+
+void MainWindow::slotStructureWalked(const StructureWalk &walk)
+{   // lists are shown flat, trees keep their shape. Items are built detached and added at once
+    ui->walkView->clear();
+    const std::vector<StructureWalk::Node>& nodes = walk.getNodes();
+    bool flat = ui->walkLinks->text().split(',', QString::SkipEmptyParts).size() == 1;
+    std::vector<QTreeWidgetItem*> items;
+    items.reserve(nodes.size());
+    for(size_t i=0;i<nodes.size();++i)
+    {
+        const StructureWalk::Node& node = nodes[i];
+        QTreeWidgetItem* item = new QTreeWidgetItem();
+        QString name = node.parent == -1 ? tr("root") : node.link;
+        item->setText(0, flat ? QString("[%1]").arg(i) : name);
+        item->setText(1, node.address);
+        item->setText(2, node.reference == -1 ? node.values.join(", ")
+                                              : tr("same as node %1").arg(node.reference));
+        if(!flat && node.parent >= 0 && node.parent < static_cast<int>(i))
+        {
+            items[node.parent]->addChild(item);
+        }
+        items.push_back(item);
+    }
+    QList<QTreeWidgetItem*> topLevel;
+    for(size_t i=0;i<items.size();++i)
+    {
+        if(flat || items[i]->parent() == nullptr)
+        {
+            topLevel << items[i];
+        }
+    }
+    ui->walkView->addTopLevelItems(topLevel);
+    ui->walkStatus->setText(tr("%1 nodes%2").arg(nodes.size())
+                            .arg(walk.isTruncated() ? tr(", stopped at node limit") : QString()));
+}
+
+void MainWindow::slotRegisterNamesRecieved()
+{   // rows are created once, later only values of changed registers are set
+    ui->registersView->clear();
+    mHighlightedRegisters.clear();
+    mRegisterItems.assign(mRegisters->size(), nullptr);
+    QList<QTreeWidgetItem*> items;
+    for(int i=0;i<mRegisters->size();++i)
+    {
+        if(mRegisters->getName(i).isEmpty())
+        {
+            continue;
+        }
+        QTreeWidgetItem* item = new QTreeWidgetItem(QStringList() << mRegisters->getName(i));
+        mRegisterItems[i] = item;
+        items << item;
+    }
+    ui->registersView->addTopLevelItems(items);
+}
+
+void MainWindow::slotRegistersChanged(const std::vector<int> &numbers)
+{   // redraw changed registers and highlight them until the next change
+    QFont font = ui->registersView->font();
+    for(int i : mHighlightedRegisters)
+    {
+        mRegisterItems[i]->setFont(1, font);
+    }
+    mHighlightedRegisters.clear();
+    font.setBold(true);
+    for(int i : numbers)
+    {
+        if(i >= static_cast<int>(mRegisterItems.size()) || mRegisterItems[i] == nullptr)
+        {
+            continue;
+        }
+        mRegisterItems[i]->setText(1, mRegisters->getValue(i));
+        mRegisterItems[i]->setFont(1, font);
+        mHighlightedRegisters.push_back(i);
+    }
+}
+
+void MainWindow::slotDisassembled(quint64 address)
+{   // list is rebuilt only when stop is in other function, otherwise current row is moved
+    const DisassembledFunction* function = mDisassembly->find(address);
+    if(function == nullptr)
+    {
+        return;
+    }
+    if(function->start != mShownFunction || ui->disasmView->count() == 0)
+    {
+        ui->disasmView->clear();
+        for(const DisassemblyLine& i : function->lines)
+        {
+            QListWidgetItem* item = new QListWidgetItem(i.text, ui->disasmView);
+            if(i.address == 0)
+            {
+                item->setForeground(Qt::darkGreen);
+            }
+        }
+        mShownFunction = function->start;
+        ui->disasmFunction->setText(function->name);
+    }
+    for(size_t i=0;i<function->lines.size();++i)
+    {
+        if(function->lines[i].address == address)
+        {
+            ui->disasmView->setCurrentRow(static_cast<int>(i));
+            ui->disasmView->scrollToItem(ui->disasmView->currentItem(), QAbstractItemView::PositionAtCenter);
+            break;
+        }
+    }
+}
+
+void MainWindow::slotDisassemblySourceToggled(bool interleaved)
+{
+    mDisassembly->setSourceInterleaved(interleaved);
+    mShownFunction = 0;
+    ui->disasmView->clear();
+}
+
+bool MainWindow::isSourceFile(const QString &fileName) const
+{   // GDB may report full or bare file name, compare full names if possible
+    const QString& shown = ui->sourceView->getFileName();
+    if(fileName.isEmpty() || shown.isEmpty())
+    {
+        return false;
+    }
+    QFileInfo file(fileName);
+    QFileInfo shownFile(shown);
+    if(file.isAbsolute())
+    {
+        return file.canonicalFilePath() == shownFile.canonicalFilePath();
+    }
+    return file.fileName() == shownFile.fileName();
+}
+
+void MainWindow::updateSourceBreakpoints()
+{
+    std::set<int> lines;
+    for(const Breakpoint& i : mProcess->getBreakpoints())
+    {
+        if(isSourceFile(i.getFile()))
+        {
+            lines.insert(i.getLine());
+        }
+    }
+    ui->sourceView->setBreakpointLines(lines);
+}
+
+void MainWindow::slotOpenSource()
+{
+    QString fileName = ui->sourcePath->text().trimmed();
+    if(!ui->sourceView->open(fileName))
+    {
+        ui->designOutput->appendPlainText(tr("Can't open %1").arg(fileName));
+        return;
+    }
+    updateSourceBreakpoints();
+}
+
+void MainWindow::slotShowStopLocation(const MiRecord &record)
+{   // open file of stop frame if needed and mark current line
+    const MiValue& frame = record["frame"];
+    QString fileName = frame["fullname"].getString();
+    int line = frame["line"].getString().toInt();
+    if(fileName.isEmpty() || line == 0)
+    {
+        ui->sourceView->setCurrentLine(0);
+        return;
+    }
+    if(!isSourceFile(fileName))
+    {
+        if(!ui->sourceView->open(fileName))
+        {
+            return;
+        }
+        ui->sourcePath->setText(fileName);
+        updateSourceBreakpoints();
+    }
+    ui->sourceView->setCurrentLine(line);
+    ui->sourceView->showLine(line);
+}
+
+void MainWindow::slotTargetRunning()
+{
+    ui->sourceView->setCurrentLine(0);
+}
+
+void MainWindow::slotSourceGutterClicked(int line)
+{   // toggle breakpoint at $line$ of shown file
+    bool deleted = false;
+    for(const Breakpoint& i : mProcess->getBreakpoints())
+    {
+        if(i.getLine() == line && isSourceFile(i.getFile()))
+        {
+            mProcess->deleteBreakpoint(i.getNumber());
+            deleted = true;
+        }
+    }
+    if(!deleted)
+    {
+        mProcess->insertBreakpoint(QString("%1:%2").arg(ui->sourceView->getFileName()).arg(line));
+    }
+}
+
+void MainWindow::slotStartupProgress(const QString &message)
+{
+    statusBar()->showMessage(message);
+}
+
+void MainWindow::slotStartupFailed(const QString &error)
+{
+    statusBar()->showMessage(tr("Startup failed: %1").arg(error));
+    ui->designOutput->appendPlainText(error);
+}
+
+void MainWindow::slotStartupFinished()
+{   // index symbols when target is stopped first time, GDB has nothing else to do then
+    mSymbolIndex->load(mStartup->getExecutable());
+}
+
+void MainWindow::slotSymbolIndexProgress(const QString &message)
+{
+    ui->symbolStatus->setText(message);
+}
+
+void MainWindow::slotSearchSymbols()
+{
+    ui->symbolsView->clear();
+    QList<QTreeWidgetItem*> items;
+    for(const SymbolInfo& i : mSymbolIndex->search(ui->symbolQuery->text()))
+    {
+        QString location = i.file.isEmpty() ? QString() : QString("%1:%2").arg(i.file).arg(i.line);
+        QTreeWidgetItem* item = new QTreeWidgetItem(QStringList() << i.name << location << i.description);
+        item->setData(0, Qt::UserRole, i.file);
+        item->setData(1, Qt::UserRole, i.line);
+        item->setData(2, Qt::UserRole, i.function);
+        items.append(item);
+    }
+    ui->symbolsView->addTopLevelItems(items);
+}
+
+void MainWindow::slotSymbolActivated(QTreeWidgetItem *item)
+{   // show declaration of symbol in source view
+    QString fileName = item->data(0, Qt::UserRole).toString();
+    int line = item->data(1, Qt::UserRole).toInt();
+    if(fileName.isEmpty())
+    {
+        return;
+    }
+    if(!isSourceFile(fileName))
+    {
+        if(!ui->sourceView->open(fileName))
+        {
+            ui->designOutput->appendPlainText(tr("Can't open %1").arg(fileName));
+            return;
+        }
+        ui->sourcePath->setText(fileName);
+        updateSourceBreakpoints();
+    }
+    ui->sourceView->showLine(line);
+    ui->tabWidget->setCurrentWidget(ui->tabSource);
+}
+
+void MainWindow::slotSymbolBreakpoint()
+{
+    QTreeWidgetItem* item = ui->symbolsView->currentItem();
+    if(item == nullptr || !item->data(2, Qt::UserRole).toBool())
+    {
+        return;
+    }
+    mProcess->insertBreakpoint(item->text(0));
+}
+
+void MainWindow::slotOpenCore()
+{
+    QString executable = ui->coreExecutable->text().trimmed();
+    QString coreFile = ui->coreFile->text().trimmed();
+    if(executable.isEmpty() || coreFile.isEmpty() || mCoreSnapshot->isCapturing())
+    {
+        return;
+    }
+    mCoreSnapshot->load(executable, coreFile);
+}
+
+void MainWindow::slotCaptureSnapshot()
+{   // snapshot of live stopped target is taken the same way as of core
+    mCoreSnapshot->capture();
+}
+
+void MainWindow::slotCoreProgress(const QString &message)
+{
+    ui->coreStatus->setText(message);
+}
+
+void MainWindow::slotSnapshotCaptured()
+{   // items keep thread id and frame index, selected frame is shown from snapshot without GDB
+    if(!mStateFile.isEmpty())
+    {
+        saveState();
+    }
+    ui->coreThreadsView->clear();
+    ui->coreVariablesView->clear();
+    QList<QTreeWidgetItem*> threads;
+    for(const SnapshotThread& i : mCoreSnapshot->getThreads())
+    {
+        QTreeWidgetItem* thread = new QTreeWidgetItem(QStringList() << QString("%1 %2").arg(i.id).arg(i.name) << i.targetId);
+        thread->setData(0, Qt::UserRole, i.id);
+        thread->setData(1, Qt::UserRole, -1);
+        for(size_t j = 0; j < i.frames.size(); ++j)
+        {
+            const SnapshotFrame& frame = i.frames[j];
+            QString location = frame.file.isEmpty() ? QString("0x%1").arg(frame.address, 0, 16)
+                                                    : QString("%1:%2").arg(frame.file).arg(frame.line);
+            QTreeWidgetItem* item = new QTreeWidgetItem(thread, QStringList() << QString("#%1 %2").arg(frame.level).arg(frame.function)
+                                                        << location);
+            item->setData(0, Qt::UserRole, i.id);
+            item->setData(1, Qt::UserRole, static_cast<int>(j));
+        }
+        threads.append(thread);
+    }
+    ui->coreThreadsView->addTopLevelItems(threads);
+}
+
+void MainWindow::slotSnapshotFrameSelected(QTreeWidgetItem *item)
+{
+    ui->coreVariablesView->clear();
+    if(item == nullptr)
+    {
+        return;
+    }
+    const SnapshotThread* thread = mCoreSnapshot->findThread(item->data(0, Qt::UserRole).toInt());
+    int frame = item->data(1, Qt::UserRole).toInt();
+    if(thread == nullptr || frame < 0 || frame >= static_cast<int>(thread->frames.size()))
+    {
+        return;
+    }
+    QList<QTreeWidgetItem*> items;
+    for(const SnapshotVariable& i : thread->frames[frame].variables)
+    {
+        QString name = i.argument ? tr("%1 (argument)").arg(i.name) : i.name;
+        items.append(new QTreeWidgetItem(QStringList() << name << i.type << i.value));
+    }
+    ui->coreVariablesView->addTopLevelItems(items);
+}
+
+void MainWindow::slotSaveState()
+{   // stacks are captured first, state is written when capture finishes
+    mStateFile = ui->stateFile->text().trimmed();
+    if(mStateFile.isEmpty())
+    {
+        return;
+    }
+    ui->stateStatus->setText(tr("Capturing state"));
+    mCoreSnapshot->capture();
+}
+
+void MainWindow::saveState()
+{
+    StateSnapshotWriter writer;
+    for(const Variable& i : mProcess->getLocalVariables())
+    {
+        writer.addVariable("locals/", i);
+    }
+    for(const Breakpoint& i : mProcess->getBreakpoints())
+    {
+        writer.addBreakpoint(i);
+    }
+    writer.addThreads(mCoreSnapshot->getThreads());
+    if(writer.save(mStateFile))
+    {
+        ui->stateStatus->setText(tr("%1 records saved to %2").arg(writer.size()).arg(mStateFile));
+    }
+    else
+    {
+        ui->stateStatus->setText(tr("Can't save %1").arg(mStateFile));
+    }
+    mStateFile.clear();
+}
+
+void MainWindow::slotDiffStates()
+{   // files are mapped and merged record by record, only the first differences are shown
+    const int maxShown = 10000;
+    StateSnapshotFile before;
+    StateSnapshotFile after;
+    if(!before.open(ui->stateBefore->text().trimmed()) || !after.open(ui->stateAfter->text().trimmed()))
+    {
+        ui->stateStatus->setText(before.getError().isEmpty() ? after.getError() : before.getError());
+        return;
+    }
+    QElapsedTimer clock;
+    clock.start();
+    QList<QTreeWidgetItem*> items;
+    qint64 changes = StateSnapshotFile::diff(before, after, [&](const StateSnapshotFile::Change& change)
+    {
+        if(items.size() < maxShown)
+        {
+            QString kind = change.kind == StateSnapshotFile::Change::Added ? tr("added")
+                         : (change.kind == StateSnapshotFile::Change::Removed ? tr("removed") : tr("changed"));
+            auto describe = [](const QByteArray& type, const QByteArray& value)
+            {
+                return type.isEmpty() && value.isEmpty() ? QString()
+                                                         : QString("%1 %2").arg(QString::fromUtf8(type), QString::fromUtf8(value));
+            };
+            items.append(new QTreeWidgetItem(QStringList() << QString::fromUtf8(change.path) << kind
+                                             << describe(change.oldType, change.oldValue)
+                                             << describe(change.newType, change.newValue)));
+        }
+        return true;
+    });
+    ui->stateDiffView->clear();
+    ui->stateDiffView->addTopLevelItems(items);
+    ui->stateStatus->setText(tr("%1 differences between %2 and %3 records found in %4 ms")
+                             .arg(changes).arg(before.size()).arg(after.size()).arg(clock.elapsed()));
+}
+
+void MainWindow::slotCancelPrint()
+{
+    mProcess->cancelPrint();
+}
+
+void MainWindow::slotPrintProgress(const QString &expression, qint64 size)
+{   // $size$ is -1 when print is finished
+    if(size < 0)
+    {
+        statusBar()->clearMessage();
+        return;
+    }
+    statusBar()->showMessage(tr("Printing %1: %2 MB").arg(expression).arg(size / (1024*1024)));
+}
+
+void MainWindow::slotLargeContentCaptured(const PrintCapturePtr &capture)
+{   // value is too large for Variable, its outer fields are shown and the rest is read on expanding
+    QTreeWidgetItem* parent = nullptr;
+    auto pointer = std::find_if(mPointersContent.begin(), mPointersContent.end(),
+                                [&](const std::pair<const Variable, QTreeWidgetItem*>& item)
+                                {
+                                    return item.first.getName() == capture->getExpression();
+                                });
+    if(pointer != mPointersContent.end())
+    {
+        parent = pointer->second;
+        mPointersContent.erase(pointer);
+    }
+    QTreeWidgetItem* root = parent != nullptr ? new QTreeWidgetItem(parent) : new QTreeWidgetItem(ui->treeWidget);
+    root->setText(0, capture->getExpression());
+    root->setText(1, tr("<%1 characters%2>").arg(capture->size())
+                  .arg(capture->isCancelled() ? tr(", cancelled") : QString()));
+    mLargeValues[root] = capture;
+    if(capture->getFields().empty())
+    {
+        root->setText(1, capture->read(0, 256));
+        return;
+    }
+    addLargeValueFields(root, *capture, capture->getFields());
+    if(capture->isIndexTruncated())
+    {
+        new QTreeWidgetItem(root, QStringList() << QString() << tr("<only the first %1 items are shown>")
+                            .arg(PrintCapture::getMaxFields()));
+    }
+}
+
+void MainWindow::addLargeValueFields(QTreeWidgetItem *parent, const PrintCapture &capture,
+                                     const std::vector<PrintCapture::Field> &fields)
+{   // items keep position of field in capture and are filled when expanded
+    const int previewLength = 256;
+    QList<QTreeWidgetItem*> items;
+    for(size_t i = 0; i < fields.size(); ++i)
+    {
+        const PrintCapture::Field& field = fields[i];
+        QString key = capture.readKey(field);
+        QString value = capture.readValue(field, previewLength);
+        qint64 valueStart = field.valueStart == -1 ? field.start : field.valueStart;
+        bool cut = field.end - valueStart > previewLength;
+        QTreeWidgetItem* item = new QTreeWidgetItem(QStringList() << (key.isEmpty() ? QString("[%1]").arg(i) : key)
+                                                    << (cut ? value + "..." : value));
+        if(value.startsWith('{'))
+        {
+            item->setData(0, FieldStartRole, field.start);
+            item->setData(0, FieldValueRole, field.valueStart);
+            item->setData(0, FieldEndRole, field.end);
+            item->setChildIndicatorPolicy(QTreeWidgetItem::ShowIndicator);
+        }
+        items.append(item);
+    }
+    parent->addChildren(items);
+}
+
+void MainWindow::slotRefreshInferiorOutput()
+{   // program may print hundreds of megabytes per second, only the tail of what came
+    // during the last tick is shown. Decoder keeps characters split between ticks
+    const int maxShown = 256*1024;
+    if(!mTerminal->isOpen())
+    {
+        return;
+    }
+    QByteArray output = mTerminal->takeOutput();
+    if(output.isEmpty())
+    {
+        return;
+    }
+    if(output.size() > maxShown)
+    {
+        int skipped = output.size() - maxShown;
+        int lineEnd = output.indexOf('\n', skipped);
+        output.remove(0, lineEnd == -1 ? skipped : lineEnd + 1);
+        delete mOutputDecoder;  // partial character in decoder belongs to dropped text
+        mOutputDecoder = QTextCodec::codecForName("UTF-8")->makeDecoder();
+        ui->inferiorOutput->appendPlainText(tr("<%1 bytes skipped>").arg(skipped));
+    }
+    QString text = mOutputDecoder->toUnicode(output);
+    if(text.endsWith('\n'))
+    {
+        text.chop(1);
+    }
+    QTextCursor cursor(ui->inferiorOutput->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(text);
+    ui->outputStatus->setText(tr("%1 MB received, %2 MB dropped")
+                              .arg(mTerminal->getTotalBytes() / (1024.0*1024), 0, 'f', 1)
+                              .arg(mTerminal->getDroppedBytes() / (1024.0*1024), 0, 'f', 1));
+}
+
+void MainWindow::slotFindOutput()
+{   // search from cursor, wrap to the beginning once
+    QString text = ui->outputSearch->text();
+    if(text.isEmpty())
+    {
+        return;
+    }
+    if(!ui->inferiorOutput->find(text))
+    {
+        ui->inferiorOutput->moveCursor(QTextCursor::Start);
+        ui->inferiorOutput->find(text);
+    }
+}
+
+void MainWindow::slotClearOutput()
+{
+    ui->inferiorOutput->clear();
+}
+
+void MainWindow::logEvent(const QString &text)
+{   // user actions are logged among GDB records to see what caused them
+    mSessionLog.append(SessionLog::Event, text);
+}
+
+void MainWindow::slotSearchSession()
+{
+    startSessionSearch(0);
+}
+
+void MainWindow::slotJumpSessionTime()
+{   // list records from the time of the day in time field. Time before session start means the next day
+    QDateTime start = QDateTime::fromMSecsSinceEpoch(mSessionLog.getStartTime());
+    QDateTime time(start.date(), ui->sessionTime->time());
+    if(time.addSecs(1) < start)
+    {
+        time = time.addDays(1);
+    }
+    startSessionSearch(mSessionLog.findTime(start.msecsTo(time)));
+}
+
+void MainWindow::slotMoreSession()
+{   // the next page of matches of the last search
+    mSessionShown = 0;
+    ui->sessionView->clear();
+    mSessionSearchTimer.start(0);
+}
+
+void MainWindow::startSessionSearch(qint64 from)
+{
+    mSessionQuery.kinds = ui->sessionKind->currentData().toUInt();
+    mSessionQuery.pattern.setPattern(ui->sessionPattern->text());
+    if(!mSessionQuery.pattern.isValid())
+    {
+        ui->sessionStatus->setText(mSessionQuery.pattern.errorString());
+        return;
+    }
+    mSessionQuery.pattern.optimize();
+    mSessionPosition = from;
+    mSessionShown = 0;
+    ui->sessionView->clear();
+    mSessionSearchTimer.start(0);
+}
+
+void MainWindow::slotContinueSessionSearch()
+{   // search for a few milliseconds and let GUI handle events before the next step
+    const qint64 stepTime = 30;     // ms
+    const int pageSize = 1000;      // matches listed at once, "More" lists the next ones
+    std::vector<qint64> matches;
+    mSessionPosition = mSessionLog.search(mSessionQuery, mSessionPosition, stepTime, pageSize - mSessionShown, matches);
+    QList<QTreeWidgetItem*> items;
+    for(qint64 i : matches)
+    {
+        const SessionLog::Entry& entry = mSessionLog.at(i);
+        QTreeWidgetItem* item = new QTreeWidgetItem();
+        item->setText(0, QDateTime::fromMSecsSinceEpoch(mSessionLog.getStartTime() + entry.time).toString("hh:mm:ss.zzz"));
+        item->setText(1, SessionLog::getKindName(entry.kind));
+        item->setText(2, entry.token == -1 ? QString() : QString::number(entry.token));
+        item->setText(3, entry.thread == -1 ? QString() : QString::number(entry.thread));
+        item->setText(4, mSessionLog.readText(i));
+        items << item;
+    }
+    ui->sessionView->addTopLevelItems(items);
+    mSessionShown += static_cast<int>(matches.size());
+    bool finished = mSessionPosition >= mSessionLog.size();
+    ui->sessionStatus->setText(tr("%1 of %2 records searched, %3 shown%4").arg(mSessionPosition)
+                               .arg(mSessionLog.size()).arg(mSessionShown)
+                               .arg(finished ? QString() : tr(", searching...")));
+    if(finished || mSessionShown >= pageSize)
+    {
+        if(!finished)
+        {
+            ui->sessionStatus->setText(tr("%1 of %2 records searched, the first %3 matches shown")
+                                       .arg(mSessionPosition).arg(mSessionLog.size()).arg(mSessionShown));
+        }
+        return;
+    }
+    mSessionSearchTimer.start(0);
+}
+
+void MainWindow::slotInsertWatchpoint()
+{
+    QString expression = ui->wpExpression->text().trimmed();
+    if(expression.isEmpty())
+    {
+        return;
+    }
+    static const Breakpoint::WatchKind kinds[] = {Breakpoint::WatchWrite, Breakpoint::WatchRead, Breakpoint::WatchAccess};
+    logEvent(QString("watch %1").arg(expression));
+    mProcess->insertWatchpoint(expression, kinds[ui->wpKind->currentIndex()],
+                               ui->wpRecord->isChecked(), ui->wpCapacity->value());
+}
+
+void MainWindow::slotWatchHistoryChanged()
+{
+    mWatchHistoryChanged = true;
+}
+
+void MainWindow::slotRefreshWatchHistory()
+{   // the last hits, newest first, and places values were touched from, most frequent first
+    const int shownHits = 1000;
+    if(!mWatchHistoryChanged)
+    {
+        return;
+    }
+    mWatchHistoryChanged = false;
+    const WatchHistory& history = mProcess->getWatchHistory();
+    const std::deque<WatchHistory::Hit>& hits = history.getHits();
+    QList<QTreeWidgetItem*> items;
+    for(auto i = hits.rbegin(); i != hits.rend() && items.size() < shownHits; ++i)
+    {
+        const WatchHistory::Site& site = history.getSite(i->site);
+        items << new QTreeWidgetItem(QStringList() << QString::number(i->index) << QString::number(i->watchpoint)
+                                     << QString::number(i->thread) << site.function << site.location
+                                     << i->oldValue << i->newValue);
+    }
+    ui->wpHistoryView->clear();
+    ui->wpHistoryView->addTopLevelItems(items);
+
+    std::vector<const WatchHistory::Site*> sites;
+    for(const WatchHistory::Site& i : history.getSites())
+    {
+        sites.push_back(&i);
+    }
+    std::sort(sites.begin(), sites.end(), [](const WatchHistory::Site* a, const WatchHistory::Site* b){return a->hits > b->hits;});
+    items.clear();
+    std::map<int, qint64> totals;
+    for(const WatchHistory::Site* i : sites)
+    {
+        items << new QTreeWidgetItem(QStringList() << QString::number(i->watchpoint) << i->function
+                                     << i->location << QString::number(i->hits));
+        totals[i->watchpoint] = history.getHitCount(i->watchpoint);
+    }
+    ui->wpSitesView->clear();
+    ui->wpSitesView->addTopLevelItems(items);
+
+    QStringList status;
+    for(const auto& i : totals)
+    {
+        status << tr("#%1: %2 hits").arg(i.first).arg(i.second);
+    }
+    ui->wpStatus->setText(tr("%1, the last %2 of %3 kept hits shown").arg(status.join(", "))
+                          .arg(std::min<size_t>(hits.size(), shownHits)).arg(hits.size()));
+}
+
+void MainWindow::slotClearWatchHistory()
+{
+    mProcess->clearWatchHistory();
+    mWatchHistoryChanged = true;
+}
+
+void MainWindow::slotConnectRemote()
+{   // running GDB is switched to gdbserver, local target is dropped
+    QString address = ui->remoteAddress->text().trimmed();
+    QString executable = ui->remoteExecutable->text().trimmed();
+    if(address.isEmpty())
+    {
+        return;
+    }
+    if(executable.isEmpty() && ui->remotePid->value() == 0)
+    {   // gdbserver has nothing to launch
+        ui->remoteStatus->setText(tr("Set executable to launch or process id to attach"));
+        return;
+    }
+    logEvent(QString("connect %1").arg(address));
+    mStartup->setRemote(address, ui->remotePid->value());
+    mStartup->setPacketSize(ui->remotePacketSize->value());
+    mStartup->setLocalSysroot(ui->remoteLocalFiles->isChecked());
+    mStartup->start(executable, QStringList());
+    mStopCount = 0;
+    mStopTimeTotal = 0;
+    mStopTimeMax = 0;
+    ui->stopTimesView->clear();
+}
+
+void MainWindow::slotStopSettled(qint64 elapsed, int commands)
+{   // time from stop until every view got its data, the newest stop is on top
+    const int shownStops = 100;
+    ++mStopCount;
+    mStopTimeTotal += elapsed;
+    mStopTimeMax = std::max(mStopTimeMax, elapsed);
+    ui->stopTimesView->insertTopLevelItem(0, new QTreeWidgetItem(QStringList() << QString::number(mStopCount)
+                                          << QString::number(elapsed) << QString::number(commands)));
+    while(ui->stopTimesView->topLevelItemCount() > shownStops)
+    {
+        delete ui->stopTimesView->takeTopLevelItem(shownStops);
+    }
+    ui->remoteStatus->setText(tr("%1 target, last stop %2 ms for %3 commands, average %4 ms, max %5 ms over %6 stops")
+                              .arg(mStartup->isRemote() ? tr("Remote") : tr("Local")).arg(elapsed).arg(commands)
+                              .arg(mStopTimeTotal / mStopCount).arg(mStopTimeMax).arg(mStopCount));
+}
+
+void MainWindow::slotReverseStep()
+{
+    logEvent("reverse step");
+    mProcess->reverseStep();
+}
+
+void MainWindow::slotReverseNext()
+{
+    logEvent("reverse next");
+    mProcess->reverseNext();
+}
+
+void MainWindow::slotReverseFinish()
+{
+    logEvent("reverse finish");
+    mProcess->reverseFinish();
+}
+
+void MainWindow::slotReverseContinue()
+{
+    logEvent("reverse continue");
+    mProcess->reverseContinue();
+}
+
+void MainWindow::slotStartTimeTravel()
+{
+    if(ui->ttMode->currentIndex() == 0)
+    {
+        logEvent("record");
+        mTimeTravel->startRecording(ui->ttRecordLimit->value(), ui->ttMarkLimit->value());
+    }
+    else
+    {
+        logEvent("checkpoints");
+        mTimeTravel->startCheckpoints(ui->ttMarkLimit->value());
+    }
+}
+
+void MainWindow::slotStopTimeTravel()
+{
+    mTimeTravel->stop();
+}
+
+void MainWindow::slotGoToPresent()
+{
+    mTimeTravel->goToPresent();
+}
+
+void MainWindow::slotTimeTravelChanged()
+{   // reverse execution needs recording, checkpoints are reached from the list only
+    bool recording = mTimeTravel->getMode() == TimeTravel::Recording;
+    for(QPushButton* i : {ui->butReverseStep, ui->butReverseNext, ui->butReverseFinish, ui->butReverseContinue})
+    {
+        i->setEnabled(recording);
+    }
+    ui->butGoToPresent->setEnabled(recording && mTimeTravel->getCurrent() != 0);
+    switch(mTimeTravel->getMode())
+    {
+    case TimeTravel::Recording:
+        ui->ttStatus->setText(tr("Recorded %1 of %2 instructions, %3")
+                              .arg(mTimeTravel->getRecorded()).arg(mTimeTravel->getMaxInstructions())
+                              .arg(mTimeTravel->getCurrent() == 0 ? tr("live")
+                                   : tr("replaying instruction %1").arg(mTimeTravel->getCurrent())));
+        break;
+    case TimeTravel::Checkpoints:
+        ui->ttStatus->setText(tr("%1 checkpoints").arg(mTimeTravel->getMarks().size()));
+        break;
+    default:
+        ui->ttStatus->setText(tr("Off"));
+    }
+    ui->ttMarksView->clear();
+    QList<QTreeWidgetItem*> items;
+    for(auto i = mTimeTravel->getMarks().rbegin(); i != mTimeTravel->getMarks().rend(); ++i)
+    {
+        QTreeWidgetItem* item = new QTreeWidgetItem(QStringList() << QString::number(i->id) << i->location);
+        item->setData(0, Qt::UserRole, i->id);
+        items << item;
+    }
+    ui->ttMarksView->addTopLevelItems(items);
+}
+
+void MainWindow::slotTimeMarkActivated(QTreeWidgetItem *item)
+{
+    logEvent(QString("rewind to %1").arg(item->text(0)));
+    mTimeTravel->rewind(item->data(0, Qt::UserRole).toLongLong());
+}
+
+void MainWindow::slotSourceHover(const QString &expression, const QPoint &position)
+{   // tooltip is shown when value comes, evaluator waits until mouse rests
+    mHoverExpression = expression;
+    mHoverPosition = position;
+    if(expression.isEmpty())
+    {
+        QToolTip::hideText();
+    }
+    mEvaluator->hover(expression);
+}
+
+void MainWindow::slotQuickEval()
+{
+    mQuickEvalExpression = ui->quickEvalExpression->text().trimmed();
+    if(mQuickEvalExpression.isEmpty())
+    {
+        return;
+    }
+    ui->quickEvalResult->setText(tr("Evaluating %1").arg(mQuickEvalExpression));
+    mEvaluator->evaluate(mQuickEvalExpression);
+}
+
+void MainWindow::slotEvaluated(const QString &expression, const Evaluator::Result &result)
+{
+    QString text = result.error ? result.value : QString("(%1) %2").arg(result.type).arg(result.value);
+    if(result.truncated && !result.error)
+    {
+        text.append(" ...");
+    }
+    if(expression == mQuickEvalExpression)
+    {
+        ui->quickEvalResult->setText(QString("%1 = %2").arg(expression).arg(text));
+    }
+    if(expression == mHoverExpression)
+    {
+        QToolTip::showText(mHoverPosition, QString("%1 = %2").arg(expression).arg(text), ui->sourceView);
+    }
+}
+
+void MainWindow::slotApplyForkPolicy()
+{
+    logEvent("fork policy");
+    mProcess->setForkPolicy(ui->forkFollow->currentIndex() == 1, ui->forkDetach->isChecked(),
+                            ui->forkExecNew->isChecked(), ui->forkScheduleMultiple->isChecked());
+}
+
+void MainWindow::slotFollowStopsToggled(bool follow)
+{
+    mProcess->setFollowStops(follow);
+}
+
+void MainWindow::slotInferiorsChanged()
+{   // dozens of workers report threads and stops, table is redrawn by timer
+    mInferiorsChanged = true;
+}
+
+void MainWindow::slotRefreshInferiors()
+{
+    static const char* const stateNames[] = {QT_TR_NOOP("Not started"), QT_TR_NOOP("Running"),
+                                             QT_TR_NOOP("Stopped"), QT_TR_NOOP("Exited")};
+    if(!mInferiorsChanged)
+    {
+        return;
+    }
+    mInferiorsChanged = false;
+    const Inferiors& inferiors = mProcess->getInferiors();
+    QList<QTreeWidgetItem*> items;
+    int stopped = 0;
+    for(const auto& i : inferiors.getInferiors())
+    {
+        const Inferiors::Inferior& inferior = i.second;
+        const MiValue& frame = inferior.lastStop["frame"];
+        QString location = frame.contains("file") ? QString("%1 at %2:%3").arg(frame["func"].getString())
+                                                    .arg(frame["file"].getString()).arg(frame["line"].getString())
+                                                  : frame["func"].getString();
+        QString state = tr(stateNames[inferior.state]);
+        if(inferior.state == Inferiors::Exited && !inferior.exitCode.isEmpty())
+        {
+            state.append(QString(" (%1)").arg(inferior.exitCode));
+        }
+        QTreeWidgetItem* item = new QTreeWidgetItem(QStringList() << QString("i%1").arg(inferior.number)
+                                                    << (inferior.pid == 0 ? QString() : QString::number(inferior.pid))
+                                                    << state << QString::number(inferior.threads.size())
+                                                    << QString::number(inferior.stops) << location << inferior.executable);
+        item->setData(0, Qt::UserRole, inferior.number);
+        if(inferior.number == inferiors.getFocus())
+        {
+            QFont font = item->font(0);
+            font.setBold(true);
+            for(int column = 0; column < item->columnCount(); ++column)
+            {
+                item->setFont(column, font);
+            }
+        }
+        stopped += inferior.state == Inferiors::Stopped ? 1 : 0;
+        items << item;
+    }
+    ui->inferiorsView->clear();
+    ui->inferiorsView->addTopLevelItems(items);
+    ui->inferiorsStatus->setText(tr("%1 inferiors, %2 stopped, views show i%3")
+                                 .arg(items.size()).arg(stopped).arg(inferiors.getFocus()));
+}
+
+void MainWindow::slotInferiorActivated(QTreeWidgetItem *item)
+{   // views switch to inferior, the others keep their state
+    int number = item->data(0, Qt::UserRole).toInt();
+    logEvent(QString("focus inferior %1").arg(number));
+    mProcess->focusInferior(number);
+}
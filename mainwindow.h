@@ -3,17 +3,29 @@
 
 #include <QMainWindow>
 #include <QTreeWidget>
+#include <QTimer>
 #include "gdb.h"
+#include "hitlogmodel.h"
+#include "watchlist.h"
+#include "registers.h"
+#include "disassembly.h"
+#include "startup.h"
+#include "symbolindex.h"
+#include "coresnapshot.h"
+#include "inferiorterminal.h"
+#include "timetravel.h"
+#include "evaluator.h"
 
 namespace Ui {
 class MainWindow;
 }
 
 class QProcess;
+class QTextDecoder;
 
 struct VarComp {
     bool operator()(const Variable& a, const Variable& b) const {
-        return a.getName() < b.getName();
+        return a.getNameId() < b.getNameId();
     }
 };
 
@@ -23,13 +35,19 @@ class MainWindow : public QMainWindow
 public:
     explicit MainWindow(QWidget *parent = 0);
     ~MainWindow();
-    void addTreeRoot(Variable var);
+    void addTreeRoot(const Variable& var);
     void addTreeChild(QTreeWidgetItem *parent,
-                      Variable var, QString prefix, bool internal);
+                      const Variable& var, const QString& prefix, bool internal);
     void addTreeChildren(QTreeWidgetItem* parrent,
-                      Variable var, QString prefix, bool drfPointer = false);
+                      const Variable& var, const QString& prefix, bool drfPointer = false);
 
     void moidifyTreeItemPointer(QTreeWidgetItem* itemPointer);
+    bool isSourceFile(const QString& fileName)const;
+    void setupVarObjectItem(QTreeWidgetItem* item, const QString& varObject, int numChildren,
+                            bool dynamic, const QString& displayHint);
+    void forgetVarObjectChildren(QTreeWidgetItem* item);
+    void addLargeValueFields(QTreeWidgetItem* parent, const PrintCapture& capture,
+                             const std::vector<PrintCapture::Field>& fields);
 private slots:
     void slotReadOutput();
     void slotWriteToProcess();
@@ -48,8 +66,8 @@ private slots:
     void slotUpdtaeLocals();
 
     void slotShowVariables();
-    void slotTypeUpdated(Variable var);
-    void slotDereferenceVar(Variable var);
+    void slotTypeUpdated(const Variable& var);
+    void slotDereferenceVar(const Variable& var);
     void slotBreakpointHit(int line);
     void slotErrorOccured(QString error);
 
@@ -60,13 +78,125 @@ private slots:
     void slotContinue();
     void slotKill();
     void slotStipExecuting();
+    void slotAddLogpoint();
+    void slotRemoveLogpoint();
+    void slotClearHitLog();
+    void slotRefreshHitLog();
+    void slotInsertBreakpoint();
+    void slotBreakpointsChanged();
+    void slotRefreshBreakpoints();
+    void slotAddWatch();
+    void slotRemoveWatch();
+    void slotWatchChanged(int id);
+    void slotWatchExpanded(QTreeWidgetItem* item);
+    void slotWatchCollapsed(QTreeWidgetItem* item);
+    void slotWatchActivated(QTreeWidgetItem* item);
+    void slotWatchChildrenFetched(const QString& varObject, int from,
+                                  const std::vector<VarChild>& children, bool hasMore);
+    void slotVarObjectChanged(const QString& varObject, const QString& value, bool inScope);
+    void slotVarObjectChildrenReset(const QString& varObject);
+    void slotWalkStructure();
+    void slotStructureWalked(const StructureWalk& walk);
+    void slotRegisterNamesRecieved();
+    void slotRegistersChanged(const std::vector<int>& numbers);
+    void slotDisassembled(quint64 address);
+    void slotDisassemblySourceToggled(bool interleaved);
+    void slotOpenSource();
+    void slotShowStopLocation(const MiRecord& record);
+    void slotTargetRunning();
+    void slotSourceGutterClicked(int line);
+    void slotStartupProgress(const QString& message);
+    void slotStartupFailed(const QString& error);
+    void slotStartupFinished();
+    void slotSymbolIndexProgress(const QString& message);
+    void slotSearchSymbols();
+    void slotSymbolActivated(QTreeWidgetItem* item);
+    void slotSymbolBreakpoint();
+    void slotOpenCore();
+    void slotCaptureSnapshot();
+    void slotCoreProgress(const QString& message);
+    void slotSnapshotCaptured();
+    void slotSnapshotFrameSelected(QTreeWidgetItem* item);
+    void slotSaveState();
+    void slotCancelPrint();
+    void slotRefreshInferiorOutput();
+    void slotFindOutput();
+    void slotClearOutput();
+    void slotPrintProgress(const QString& expression, qint64 size);
+    void slotLargeContentCaptured(const PrintCapturePtr& capture);
+    void slotDiffStates();
+    void slotSearchSession();
+    void slotJumpSessionTime();
+    void slotMoreSession();
+    void slotContinueSessionSearch();
+    void slotInsertWatchpoint();
+    void slotWatchHistoryChanged();
+    void slotRefreshWatchHistory();
+    void slotClearWatchHistory();
+    void slotConnectRemote();
+    void slotStopSettled(qint64 elapsed, int commands);
+    void slotReverseStep();
+    void slotReverseNext();
+    void slotReverseFinish();
+    void slotReverseContinue();
+    void slotStartTimeTravel();
+    void slotStopTimeTravel();
+    void slotGoToPresent();
+    void slotTimeTravelChanged();
+    void slotTimeMarkActivated(QTreeWidgetItem* item);
+    void slotSourceHover(const QString& expression, const QPoint& position);
+    void slotQuickEval();
+    void slotEvaluated(const QString& expression, const Evaluator::Result& result);
+    void slotApplyForkPolicy();
+    void slotFollowStopsToggled(bool follow);
+    void slotInferiorsChanged();
+    void slotRefreshInferiors();
+    void slotInferiorActivated(QTreeWidgetItem* item);
 private:
+    void updateSourceBreakpoints();
+    void saveState();
+    void logEvent(const QString& text);
+    void startSessionSearch(qint64 from);
     Ui::MainWindow *ui;
     Gdb *mProcess;
     std::list<QTreeWidgetItem*> mPointers;
     std::map<QTreeWidgetItem*, Variable> mPointersName;
     std::map<Variable, QTreeWidgetItem*, VarComp> mTypeVar;
     std::map<Variable, QTreeWidgetItem*, VarComp> mPointersContent;
+    std::map<QTreeWidgetItem*, PrintCapturePtr> mLargeValues;  // items of values read lazily from capture
+    HitLogModel* mHitLogModel;
+    QTimer mRefreshTimer;
+    bool mBreakpointsChanged;
+    WatchList* mWatchList;
+    std::map<int, QTreeWidgetItem*> mWatchItems;
+    std::map<QString, QTreeWidgetItem*> mVarObjectItems;
+    Registers* mRegisters;
+    std::vector<QTreeWidgetItem*> mRegisterItems;
+    std::vector<int> mHighlightedRegisters;
+    Disassembly* mDisassembly;
+    quint64 mShownFunction;
+    Startup* mStartup;
+    SymbolIndex* mSymbolIndex;
+    CoreSnapshot* mCoreSnapshot;
+    QString mStateFile;     // state is saved there when snapshot capture finishes
+    InferiorTerminal* mTerminal;
+    QTextDecoder* mOutputDecoder;
+    std::map<int, QTreeWidgetItem*> mLogpointItems;
+    SessionLog mSessionLog;
+    SessionLog::Query mSessionQuery;
+    qint64 mSessionPosition;    // search continues from this entry
+    int mSessionShown;
+    QTimer mSessionSearchTimer;
+    bool mWatchHistoryChanged;
+    int mStopCount;
+    qint64 mStopTimeTotal;
+    qint64 mStopTimeMax;
+    TimeTravel* mTimeTravel;
+    Evaluator* mEvaluator;
+    QString mHoverExpression;
+    QPoint mHoverPosition;
+    QString mQuickEvalExpression;
+    bool mInferiorsChanged;
 };
 
 #endif // MAINWINDOW_H
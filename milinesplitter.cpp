@@ -0,0 +1,29 @@
+#include "milinesplitter.h"
+
+#include <algorithm>
+
+MiLineSplitter::MiLineSplitter():
+    mLineStart{0},
+    mScanFrom{0}
+{
+}
+
+void MiLineSplitter::append(const QByteArray &chunk)
+{
+    mBuffer.append(chunk);
+}
+
+bool MiLineSplitter::next(QString &line)
+{   // takes the next complete line into $line$ with its '\n', false if there is none yet
+    int lineEnd = mBuffer.indexOf('\n', std::max(mLineStart, mScanFrom));
+    if(lineEnd == -1)
+    {   // taken lines are dropped once, not after each of them
+        mBuffer.remove(0, mLineStart);
+        mLineStart = 0;
+        mScanFrom = mBuffer.size();
+        return false;
+    }
+    line = QString::fromUtf8(mBuffer.constData()+mLineStart, lineEnd-mLineStart+1);
+    mLineStart = lineEnd+1;
+    return true;
+}
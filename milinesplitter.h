@@ -0,0 +1,20 @@
+#ifndef MILINESPLITTER_H
+#define MILINESPLITTER_H
+
+#include <QByteArray>
+#include <QString>
+
+class MiLineSplitter
+{   // splits output of GDB read by chunks into complete lines. Reply of tens of MB comes
+    // by many chunks, only new chunk is searched for line end
+public:
+    MiLineSplitter();
+    void append(const QByteArray& chunk);
+    bool next(QString& line);
+private:
+    QByteArray mBuffer;
+    int mLineStart;     // start of the first line not taken by next
+    int mScanFrom;      // mBuffer before it has no '\n', unfinished line isn't searched again
+};
+
+#endif // MILINESPLITTER_H
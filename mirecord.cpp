@@ -0,0 +1,335 @@
+#include "mirecord.h"
+
+#include <algorithm>
+
+static const MiValue& emptyValue()
+{   // returned for missing keys and out of range indexes, so lookups can be chained
+    static const MiValue empty;
+    return empty;
+}
+
+MiValue::MiValue():
+    mKind{String}
+{
+}
+
+MiValue::MiValue(const QString &string):
+    mKind{String},
+    mString(string)
+{
+}
+
+MiValue::MiValue(MiValue::Kind kind):
+    mKind{kind}
+{
+}
+
+MiValue::Kind MiValue::getKind() const
+{
+    return mKind;
+}
+
+bool MiValue::isEmpty() const
+{
+    return mKind == String ? mString.isEmpty() : mValues.empty();
+}
+
+const QString &MiValue::getString() const
+{
+    return mString;
+}
+
+const MiValue &MiValue::operator[](const QString &key) const
+{   // returns value of result $key$ of tuple or empty value if there is no such key
+    for(size_t i=0;i<mKeys.size();++i)
+    {
+        if(mKeys[i] == key)
+        {
+            return mValues[i];
+        }
+    }
+    return emptyValue();
+}
+
+const MiValue &MiValue::at(int index) const
+{
+    if(index < 0 || index >= size())
+    {
+        return emptyValue();
+    }
+    return mValues[index];
+}
+
+const QString &MiValue::keyAt(int index) const
+{
+    static const QString emptyKey;
+    if(index < 0 || index >= size())
+    {
+        return emptyKey;
+    }
+    return mKeys[index];
+}
+
+int MiValue::size() const
+{
+    return static_cast<int>(mValues.size());
+}
+
+bool MiValue::contains(const QString &key) const
+{
+    return std::find(mKeys.begin(), mKeys.end(), key) != mKeys.end();
+}
+
+void MiValue::append(const QString &key, const MiValue &value)
+{   // key is empty for items of value lists
+    mKeys.push_back(key);
+    mValues.push_back(value);
+}
+
+MiRecord::MiRecord():
+    mType{Unknown},
+    mToken{-1},
+    mResults(MiValue::Tuple)
+{
+}
+
+MiRecord MiRecord::parse(const QString &line)
+{   // parses one line of GDB/MI output
+    /*
+        12^done,bkpt={number="1",type="breakpoint",line="19"}
+        *stopped,reason="breakpoint-hit",frame={func="main",line="19"}
+        ~"Reading symbols from pairs.exe...\n"
+        (gdb)
+    */
+    MiRecord record;
+    if(line.startsWith("(gdb)"))
+    {
+        record.mType = Prompt;
+        return record;
+    }
+    int pos = 0;
+    while(pos < line.size() && line[pos].isDigit())
+    {
+        ++pos;
+    }
+    if(pos > 0)
+    {
+        record.mToken = line.left(pos).toInt();
+    }
+    if(pos >= line.size())
+    {
+        return record;
+    }
+    QChar marker = line[pos++];
+    switch(marker.unicode())
+    {
+    case '^': record.mType = Result; break;
+    case '*': record.mType = ExecAsync; break;
+    case '+': record.mType = StatusAsync; break;
+    case '=': record.mType = NotifyAsync; break;
+    case '~': record.mType = ConsoleStream; break;
+    case '@': record.mType = TargetStream; break;
+    case '&': record.mType = LogStream; break;
+    default: return record;
+    }
+    if(record.isStream())
+    {
+        record.mStream = readCString(line, pos);
+        return record;
+    }
+    int comma = line.indexOf(',', pos);
+    record.mClass = line.mid(pos, comma == -1 ? -1 : comma-pos).trimmed();
+    if(comma != -1)
+    {
+        pos = comma+1;
+        readResults(line, pos, QChar(), record.mResults);
+    }
+    return record;
+}
+
+QString MiRecord::quote(const QString &text)
+{   // makes c-string which may be passed as parameter of MI command
+    QString res("\"");
+    for(QChar ch : text)
+    {
+        switch(ch.unicode())
+        {
+        case '"': res.append("\\\""); break;
+        case '\\': res.append("\\\\"); break;
+        case '\n': res.append("\\n"); break;
+        case '\t': res.append("\\t"); break;
+        default: res.append(ch);
+        }
+    }
+    res.append('"');
+    return res;
+}
+
+QString MiRecord::unescapeHelper(const QString &text)
+{   // reads field of helper command output. escape() of helpers/uidebugger.py writes '\\' as "\\\\",
+    // '|' as "\\p" and line breaks as "\\n", so fields are split by '|' and records by lines
+    QString res;
+    res.reserve(text.size());
+    for(int i=0;i<text.size();++i)
+    {
+        if(text[i] != '\\' || i+1 == text.size())
+        {
+            res.append(text[i]);
+            continue;
+        }
+        QChar next = text[++i];
+        res.append(next == 'p' ? QChar('|') : next == 'n' ? QChar('\n') : next);
+    }
+    return res;
+}
+
+MiRecord::Type MiRecord::getType() const
+{
+    return mType;
+}
+
+int MiRecord::getToken() const
+{   // returns token of command this record answers or -1
+    return mToken;
+}
+
+const QString &MiRecord::getClass() const
+{
+    return mClass;
+}
+
+const MiValue &MiRecord::getResults() const
+{
+    return mResults;
+}
+
+const MiValue &MiRecord::operator[](const QString &key) const
+{
+    return mResults[key];
+}
+
+const QString &MiRecord::getStream() const
+{
+    return mStream;
+}
+
+bool MiRecord::isStream() const
+{
+    return mType == ConsoleStream || mType == TargetStream || mType == LogStream;
+}
+
+QString MiRecord::readCString(const QString &line, int &pos)
+{   // reads c-string starting at $pos$ and unescapes it. $pos$ is moved after closing quote.
+    // GDB writes non-ASCII bytes as octal escapes, bytes of one character are decoded together as UTF-8
+    QString res;
+    QByteArray bytes;   // octal escaped bytes not decoded yet
+    if(pos >= line.size() || line[pos] != '"')
+    {
+        return res;
+    }
+    ++pos;
+    while(pos < line.size() && line[pos] != '"')
+    {
+        QChar ch = line[pos++];
+        bool octal = ch == '\\' && pos < line.size() && line[pos] >= '0' && line[pos] <= '7';
+        if(!octal && !bytes.isEmpty())
+        {
+            res.append(QString::fromUtf8(bytes));
+            bytes.clear();
+        }
+        if(ch != '\\' || pos >= line.size())
+        {
+            res.append(ch);
+            continue;
+        }
+        ch = line[pos++];
+        switch(ch.unicode())
+        {
+        case 'n': res.append('\n'); break;
+        case 't': res.append('\t'); break;
+        case 'r': res.append('\r'); break;
+        case 'a': res.append('\a'); break;
+        case 'b': res.append('\b'); break;
+        case 'f': res.append('\f'); break;
+        case 'v': res.append('\v'); break;
+        case 'e': res.append(QChar(27)); break;
+        default:
+            if(octal)
+            {   // up to three digits
+                int code = ch.unicode() - '0';
+                for(int i=0;i<2 && pos < line.size() && line[pos] >= '0' && line[pos] <= '7';++i)
+                {
+                    code = code*8 + line[pos++].unicode() - '0';
+                }
+                bytes.append(static_cast<char>(code));
+            }
+            else
+            {
+                res.append(ch);
+            }
+        }
+    }
+    if(!bytes.isEmpty())
+    {
+        res.append(QString::fromUtf8(bytes));
+    }
+    ++pos; // skip closing quote
+    return res;
+}
+
+MiValue MiRecord::readValue(const QString &line, int &pos)
+{   // value -> const | tuple | list
+    if(pos >= line.size())
+    {
+        return MiValue();
+    }
+    if(line[pos] == '"')
+    {
+        return MiValue(readCString(line, pos));
+    }
+    if(line[pos] == '{')
+    {
+        MiValue tuple(MiValue::Tuple);
+        ++pos;
+        readResults(line, pos, '}', tuple);
+        return tuple;
+    }
+    if(line[pos] == '[')
+    {
+        MiValue list(MiValue::List);
+        ++pos;
+        readResults(line, pos, ']', list);
+        return list;
+    }
+    return MiValue();
+}
+
+void MiRecord::readResults(const QString &line, int &pos, QChar closing, MiValue &into)
+{   // reads comma separated results (or bare values for lists) until $closing$
+    while(pos < line.size())
+    {
+        if(line[pos] == closing)
+        {
+            ++pos;
+            return;
+        }
+        if(line[pos] == ',')
+        {
+            ++pos;
+            continue;
+        }
+        QString key;
+        if(line[pos] != '"' && line[pos] != '{' && line[pos] != '[')
+        {
+            int equal = line.indexOf('=', pos);
+            if(equal == -1)
+            {
+                pos = line.size();
+                return;
+            }
+            key = line.mid(pos, equal-pos);
+            pos = equal+1;
+        }
+        into.append(key, readValue(line, pos));
+    }
+}
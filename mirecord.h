@@ -0,0 +1,59 @@
+#ifndef MIRECORD_H
+#define MIRECORD_H
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+class MiValue
+{
+public:
+    enum Kind{String, Tuple, List};
+    MiValue();
+    explicit MiValue(const QString& string);
+    explicit MiValue(Kind kind);
+    Kind getKind()const;
+    bool isEmpty()const;
+    const QString& getString()const;
+    const MiValue& operator[](const QString& key)const;
+    const MiValue& at(int index)const;
+    const QString& keyAt(int index)const;
+    int size()const;
+    bool contains(const QString& key)const;
+    void append(const QString& key, const MiValue& value);
+private:
+    Kind mKind;
+    QString mString;
+    std::vector<QString> mKeys;
+    std::vector<MiValue> mValues;
+};
+
+class MiRecord
+{
+public:
+    enum Type{Result, ExecAsync, StatusAsync, NotifyAsync,
+              ConsoleStream, TargetStream, LogStream, Prompt, Unknown};
+    MiRecord();
+    static MiRecord parse(const QString& line);
+    static QString quote(const QString& text);
+    static QString unescapeHelper(const QString& text);
+    Type getType()const;
+    int getToken()const;
+    const QString& getClass()const;
+    const MiValue& getResults()const;
+    const MiValue& operator[](const QString& key)const;
+    const QString& getStream()const;
+    bool isStream()const;
+private:
+    static QString readCString(const QString& line, int& pos);
+    static MiValue readValue(const QString& line, int& pos);
+    static void readResults(const QString& line, int& pos, QChar closing, MiValue& into);
+
+    Type mType;
+    int mToken;
+    QString mClass;
+    MiValue mResults;
+    QString mStream;
+};
+
+#endif // MIRECORD_H
@@ -0,0 +1,281 @@
+#include "printcapture.h"
+
+#include <QDir>
+#include <QRegExp>
+
+static const qint64 spillThreshold = 8*1024*1024; // characters kept in memory, 16 MB
+static const int maxFields = 100000;              // fields of outer structure indexed
+
+PrintCapture::PrintCapture(const QString &expression):
+    mExpression{expression},
+    mStarted{false},
+    mSkipIndent{false},
+    mFinished{false},
+    mDone{false},
+    mCancelled{false},
+    mSize{0}
+{
+}
+
+const QString &PrintCapture::getExpression() const
+{
+    return mExpression;
+}
+
+bool PrintCapture::append(const QString &chunk)
+{   //take next console record of value. Line breaks of pretty printing are dropped with indents.
+    //Returns false for output before value starts, it belongs to other commands
+    if(mFinished)
+    {
+        return false;
+    }
+    int from = 0;
+    if(!mStarted)
+    {
+        QRegExp history("^\\$\\d+ = ");
+        if(history.indexIn(chunk) == -1)
+        {
+            return false;
+        }
+        mStarted = true;
+        from = history.matchedLength();
+    }
+    if(mCancelled)
+    {
+        return true;
+    }
+    QString text;
+    text.reserve(chunk.size() - from);
+    for(int i = from; i < chunk.size(); ++i)
+    {
+        QChar ch = chunk.at(i);
+        if(ch == '\n' && !mScanner.inString)
+        {
+            mSkipIndent = true;
+            continue;
+        }
+        if(mSkipIndent)
+        {
+            if(ch == ' ')
+            {
+                continue;
+            }
+            mSkipIndent = false;
+        }
+        text.append(ch);
+    }
+    mScanner.scan(text.constData(), text.size(), mSize, mFields);
+    store(text);
+    return true;
+}
+
+void PrintCapture::finish(bool done)
+{
+    mFinished = true;
+    mDone = done && !mCancelled;
+    mScanner.closeField(mSize, mFields);
+}
+
+void PrintCapture::cancel()
+{   //the rest of output is dropped, what is captured already stays readable
+    mCancelled = true;
+}
+
+bool PrintCapture::isFinished() const
+{
+    return mFinished;
+}
+
+bool PrintCapture::isDone() const
+{
+    return mDone;
+}
+
+bool PrintCapture::isCancelled() const
+{
+    return mCancelled;
+}
+
+bool PrintCapture::isSpilled() const
+{
+    return mSpill != nullptr;
+}
+
+qint64 PrintCapture::size() const
+{
+    return mSize;
+}
+
+QString PrintCapture::read(qint64 start, qint64 length) const
+{   //read [$start$, $start$+$length$) of value. Spilled text is stored as UTF-16, so positions map to file directly
+    start = qBound<qint64>(0, start, mSize);
+    length = qBound<qint64>(0, length, mSize - start);
+    if(!mSpill)
+    {
+        return mMemory.mid(static_cast<int>(start), static_cast<int>(length));
+    }
+    QString text(static_cast<int>(length), Qt::Uninitialized);
+    mSpill->seek(start*2);
+    qint64 read = mSpill->read(reinterpret_cast<char*>(text.data()), length*2);
+    text.resize(static_cast<int>(qMax<qint64>(read, 0)/2));
+    return text;
+}
+
+QString PrintCapture::readAll() const
+{
+    return read(0, mSize);
+}
+
+const std::vector<PrintCapture::Field> &PrintCapture::getFields() const
+{
+    return mFields;
+}
+
+bool PrintCapture::isIndexTruncated() const
+{
+    return mScanner.truncated;
+}
+
+std::vector<PrintCapture::Field> PrintCapture::readFields(const Field &field, qint64 limit) const
+{   //index items of structure in value of $field$. Values longer than $limit$ aren't read
+    std::vector<Field> fields;
+    qint64 start = field.valueStart == -1 ? field.start : field.valueStart;
+    qint64 length = field.end - start;
+    if(length > limit)
+    {
+        return fields;
+    }
+    QString text = read(start, length);
+    Scanner scanner;
+    scanner.scan(text.constData(), text.size(), start, fields);
+    scanner.closeField(start + text.size(), fields);
+    return fields;
+}
+
+QString PrintCapture::readKey(const Field &field) const
+{
+    if(field.valueStart == -1)
+    {
+        return QString();
+    }
+    return read(field.start, field.valueStart - 1 - field.start).trimmed();
+}
+
+QString PrintCapture::readValue(const Field &field, qint64 limit) const
+{   //the first $limit$ characters of value
+    qint64 start = field.valueStart == -1 ? field.start : field.valueStart;
+    return read(start, qMin(field.end - start, limit)).trimmed();
+}
+
+int PrintCapture::getMaxFields()
+{
+    return maxFields;
+}
+
+void PrintCapture::store(const QString &text)
+{
+    if(!mSpill && mMemory.size() + text.size() > spillThreshold)
+    {
+        mSpill.reset(new QTemporaryFile(QDir::tempPath().append("/uidebuggerprintXXXXXX")));
+        if(mSpill->open())
+        {
+            mSpill->write(reinterpret_cast<const char*>(mMemory.constData()), mMemory.size()*2);
+            mMemory = QString();
+        }
+        else
+        {   // no place for value, keep what is captured
+            mSpill.reset();
+            mCancelled = true;
+            return;
+        }
+    }
+    if(mSpill)
+    {
+        mSpill->seek(mSize*2);  // read() may have moved position
+        mSpill->write(reinterpret_cast<const char*>(text.constData()), text.size()*2);
+    }
+    else
+    {
+        mMemory.append(text);
+    }
+    mSize += text.size();
+}
+
+void PrintCapture::Scanner::scan(const QChar *data, int size, qint64 base, std::vector<Field> &fields)
+{
+    for(int i = 0; i < size; ++i)
+    {
+        QChar ch = data[i];
+        qint64 position = base + i;
+        if(inString || inChar)
+        {
+            if(escape)
+            {
+                escape = false;
+            }
+            else if(ch == '\\')
+            {
+                escape = true;
+            }
+            else if((inString && ch == '"') || (inChar && ch == '\''))
+            {
+                inString = false;
+                inChar = false;
+            }
+            previous = ch;
+            continue;
+        }
+        if(ch == '"')
+        {
+            inString = true;
+        }
+        else if(ch == '\'')
+        {
+            inChar = true;
+        }
+        else if(ch == '{')
+        {
+            if(++level == 1)
+            {
+                fieldStart = position+1;
+                valueStart = -1;
+            }
+        }
+        else if(ch == '}')
+        {
+            if(level == 1)
+            {
+                closeField(position, fields);
+            }
+            --level;
+        }
+        else if(ch == ',' && level == 1)
+        {
+            closeField(position, fields);
+            fieldStart = position+1;
+            valueStart = -1;
+        }
+        else if(ch == '=' && level == 1 && valueStart == -1 && previous == ' ')
+        {
+            valueStart = position+1;
+        }
+        previous = ch;
+    }
+}
+
+void PrintCapture::Scanner::closeField(qint64 end, std::vector<Field> &fields)
+{
+    if(fieldStart == -1 || end <= fieldStart)
+    {
+        return;
+    }
+    if(static_cast<int>(fields.size()) < maxFields)
+    {
+        fields.push_back(Field{fieldStart, valueStart, end});
+    }
+    else
+    {
+        truncated = true;
+    }
+    fieldStart = -1;
+}
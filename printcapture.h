@@ -0,0 +1,71 @@
+#ifndef PRINTCAPTURE_H
+#define PRINTCAPTURE_H
+
+#include <QString>
+#include <QTemporaryFile>
+
+#include <memory>
+#include <vector>
+
+class PrintCapture
+{   // value printed by GDB, collected chunk by chunk as console records come. Fields of the
+    // outer structure are indexed on the fly, text above spill threshold is moved to temporary file
+public:
+    struct Field
+    {   // positions in value text. valueStart is -1 for array elements
+        qint64 start;
+        qint64 valueStart;
+        qint64 end;
+    };
+
+    explicit PrintCapture(const QString& expression);
+    const QString& getExpression()const;
+    bool append(const QString& chunk);
+    void finish(bool done);
+    void cancel();
+    bool isFinished()const;
+    bool isDone()const;
+    bool isCancelled()const;
+    bool isSpilled()const;
+    qint64 size()const;
+    QString read(qint64 start, qint64 length)const;
+    QString readAll()const;
+    const std::vector<Field>& getFields()const;
+    bool isIndexTruncated()const;
+    std::vector<Field> readFields(const Field& field, qint64 limit)const;
+    QString readKey(const Field& field)const;
+    QString readValue(const Field& field, qint64 limit)const;
+    static int getMaxFields();
+
+private:
+    struct Scanner
+    {   // finds items of the first level of braces, quoted text is skipped
+        int level = 0;
+        bool inString = false;
+        bool inChar = false;
+        bool escape = false;
+        QChar previous;
+        qint64 fieldStart = -1;
+        qint64 valueStart = -1;
+        bool truncated = false;
+        void scan(const QChar* data, int size, qint64 base, std::vector<Field>& fields);
+        void closeField(qint64 end, std::vector<Field>& fields);
+    };
+    void store(const QString& text);
+
+    QString mExpression;
+    bool mStarted;      // "$1 = " prefix is passed
+    bool mSkipIndent;   // pretty printed values are joined into one line
+    bool mFinished;
+    bool mDone;
+    bool mCancelled;
+    qint64 mSize;
+    QString mMemory;
+    std::unique_ptr<QTemporaryFile> mSpill;
+    Scanner mScanner;
+    std::vector<Field> mFields;
+};
+
+typedef std::shared_ptr<PrintCapture> PrintCapturePtr;
+
+#endif // PRINTCAPTURE_H
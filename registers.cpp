@@ -0,0 +1,139 @@
+#include "registers.h"
+
+Registers::Registers(Gdb *gdb, QObject *parent):
+    QObject(parent),
+    mGdb{gdb},
+    mNamesRequested{false},
+    mValuesKnown{false},
+    mValuesStale{false}
+{
+    connect(mGdb, SIGNAL(signalStopped(MiRecord)), this, SLOT(slotStopped()), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalFocusChanged(MiRecord)), this, SLOT(slotFocusChanged()), Qt::UniqueConnection);
+}
+
+int Registers::size() const
+{
+    return static_cast<int>(mNames.size());
+}
+
+const QString &Registers::getName(int number) const
+{   // name of register $number$, empty for unused numbers
+    return mNames[number];
+}
+
+const QString &Registers::getValue(int number) const
+{
+    return mValues[number];
+}
+
+void Registers::update()
+{   // names are read once, values of all registers on the first stop and then only of changed ones
+    if(!mNamesRequested)
+    {
+        /*
+            ^done,register-names=["rax","rbx","rcx","","rip"]
+        */
+        mNamesRequested = true;
+        mGdb->sendCommand("-data-list-register-names", [this](const MiRecord& record)
+        {
+            const MiValue& names = record["register-names"];
+            if(record.getClass() != "done" || names.size() == 0)
+            {
+                mNamesRequested = false;   // no target yet, try again on the next stop
+                return;
+            }
+            mNames.resize(names.size());
+            mValues.resize(names.size());
+            for(int i=0;i<names.size();++i)
+            {
+                mNames[i] = names.at(i).getString();
+            }
+            emit signalNamesRecieved();
+            readValues(QString());
+        }, true, CommandScheduler::View, Gdb::getStopGroup());
+        return;
+    }
+    if(!mValuesKnown)
+    {
+        return; // the first full read is still in progress
+    }
+    if(mValuesStale)
+    {
+        mValuesStale = false;
+        readValues(QString());
+        return;
+    }
+    /*
+        ^done,changed-registers=["0","1","16"]
+    */
+    mGdb->sendCommand("-data-list-changed-registers", [this](const MiRecord& record)
+    {
+        const MiValue& changed = record["changed-registers"];
+        if(record.getClass() != "done" || changed.size() == 0)
+        {
+            return;
+        }
+        QStringList numbers;
+        for(int i=0;i<changed.size();++i)
+        {
+            numbers << changed.at(i).getString();
+        }
+        readValues(numbers.join(' '));
+    }, true, CommandScheduler::View, Gdb::getStopGroup());
+}
+
+void Registers::slotStopped()
+{
+    update();
+}
+
+void Registers::slotFocusChanged()
+{   // GDB tells changes since the last read of selected thread, other process needs full read
+    if(mValuesKnown)
+    {
+        readValues(QString());
+    }
+    else
+    {
+        update();
+    }
+}
+
+void Registers::readValues(const QString &numbers)
+{   // read values of registers listed in $numbers$ or of all registers if it is empty
+    /*
+        ^done,register-values=[{number="0",value="0x7ffe"},{number="16",value="0x401516"}]
+    */
+    QString command = QString("-data-list-register-values --skip-unavailable x %1").arg(numbers);
+    bool all = numbers.isEmpty();
+    mGdb->sendCommand(command.trimmed(), [this, all](const MiRecord& record)
+    {
+        if(record.getClass() != "done")
+        {
+            if(all)
+            {
+                mNamesRequested = false;    // start from names on the next stop
+            }
+            else
+            {   // dropped when target resumed, but GDB already took the changes as read
+                mValuesStale = true;
+            }
+            return;
+        }
+        mValuesKnown = true;
+        const MiValue& values = record["register-values"];
+        std::vector<int> changed;
+        changed.reserve(values.size());
+        for(int i=0;i<values.size();++i)
+        {
+            int number = values.at(i)["number"].getString().toInt();
+            if(number < 0 || number >= size())
+            {
+                continue;
+            }
+            mValues[number] = values.at(i)["value"].getString();
+            changed.push_back(number);
+        }
+        emit signalRegistersChanged(changed);
+    }, true, CommandScheduler::View, Gdb::getStopGroup());
+}
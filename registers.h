@@ -0,0 +1,40 @@
+#ifndef REGISTERS_H
+#define REGISTERS_H
+
+#include <QObject>
+#include <QString>
+
+#include <vector>
+
+#include "gdb.h"
+
+class Registers : public QObject
+{
+    Q_OBJECT
+public:
+    explicit Registers(Gdb* gdb, QObject* parent = 0);
+    int size()const;
+    const QString& getName(int number)const;
+    const QString& getValue(int number)const;
+    void update();
+
+public slots:
+    void slotStopped();
+    void slotFocusChanged();
+
+signals:
+    void signalNamesRecieved();
+    void signalRegistersChanged(const std::vector<int>& numbers);
+
+private:
+    void readValues(const QString& numbers);
+
+    Gdb* mGdb;
+    std::vector<QString> mNames;   // both arrays are indexed by register number,
+    std::vector<QString> mValues;  // their size is set once when names are recieved
+    bool mNamesRequested;
+    bool mValuesKnown;
+    bool mValuesStale;  // GDB reported changes which weren't read, it won't report them again
+};
+
+#endif // REGISTERS_H
@@ -0,0 +1,272 @@
+#include "sessionlog.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+static const qint64 blockSize = 4*1024*1024;   // bytes read from file at once by search
+static const size_t batchRecords = 512;         // records are written by batches of this size
+static const qint64 batchSize = 256*1024;       // or of this number of characters
+static const int keepSessions = 20;             // logs of previous sessions kept in log directory
+static const qint64 keepBytes = 1024*1024*1024; // and their total size limit
+static const char* const kindNames[] = {"command", "result", "error", "exec", "status", "notify",
+                                        "console", "target", "log", "event"};
+
+SessionLog::SessionLog():
+    mStartTime{0},
+    mWritten{0},
+    mPendingSize{0},
+    mBlockStart{0}
+{
+}
+
+SessionLog::~SessionLog()
+{
+    close();
+}
+
+bool SessionLog::open(const QString &fileName)
+{   //start new log in $fileName$. Existing file is overwritten
+    close();
+    QDir().mkpath(QFileInfo(fileName).path());
+    mWriter.setFileName(fileName);
+    mReader.setFileName(fileName);
+    if(!mWriter.open(QIODevice::WriteOnly | QIODevice::Truncate) || !mReader.open(QIODevice::ReadOnly))
+    {
+        close();
+        return false;
+    }
+    mFileName = fileName;
+    mClock.start();
+    mStartTime = QDateTime::currentMSecsSinceEpoch();
+    return true;
+}
+
+void SessionLog::close()
+{
+    flush();
+    mWriter.close();
+    mReader.close();
+    mFileName.clear();
+    mEntries.clear();
+    mWritten = 0;
+    mBlock.clear();
+    mBlockStart = 0;
+}
+
+bool SessionLog::isOpen() const
+{
+    return mWriter.isOpen();
+}
+
+const QString &SessionLog::getFileName() const
+{
+    return mFileName;
+}
+
+qint64 SessionLog::getStartTime() const
+{   //ms since epoch, times of entries are relative to it
+    return mStartTime;
+}
+
+void SessionLog::append(Kind kind, const QString &text, int token, int thread)
+{   //only keep record here, it is formatted and written with its batch
+    if(!isOpen())
+    {
+        return;
+    }
+    mPending.push_back(Record{mClock.elapsed(), text, static_cast<qint32>(token),
+                              static_cast<qint32>(thread), static_cast<quint8>(kind)});
+    mPendingSize += text.size();
+    if(mPending.size() >= batchRecords || mPendingSize >= batchSize)
+    {
+        writeBatch();
+    }
+}
+
+void SessionLog::append(const MiRecord &record, const QString &line)
+{   //log MI record as GDB sent it. Kind, token and thread are taken from parsed $record$
+    Kind kind;
+    switch(record.getType())
+    {
+    case MiRecord::Result: kind = record.getClass() == "error" ? Error : Result; break;
+    case MiRecord::ExecAsync: kind = ExecAsync; break;
+    case MiRecord::StatusAsync: kind = StatusAsync; break;
+    case MiRecord::NotifyAsync: kind = NotifyAsync; break;
+    case MiRecord::ConsoleStream: kind = Console; break;
+    case MiRecord::TargetStream: kind = Target; break;
+    case MiRecord::Prompt: return;
+    default: kind = Log;
+    }
+    bool isNumber = false;
+    int thread = record["thread-id"].getString().toInt(&isNumber);
+    append(kind, line, record.getToken(), isNumber ? thread : -1);
+}
+
+void SessionLog::flush()
+{   //write all appended records and index them
+    writeBatch();
+    finishBatch();
+}
+
+qint64 SessionLog::size() const
+{   //number of indexed records. Records appended after the last flush or search aren't counted
+    return static_cast<qint64>(mEntries.size());
+}
+
+const SessionLog::Entry &SessionLog::at(qint64 index) const
+{
+    return mEntries[static_cast<size_t>(index)];
+}
+
+QString SessionLog::readText(qint64 index)
+{
+    finishBatch();
+    const Entry& entry = at(index);
+    if(!readBlock(entry.offset, entry.length))
+    {
+        return QString();
+    }
+    return QString::fromUtf8(mBlock.constData() + (entry.offset - mBlockStart), static_cast<int>(entry.length));
+}
+
+qint64 SessionLog::findTime(qint64 time)
+{   //index of the first entry logged at $time$ or later
+    flush();
+    auto found = std::lower_bound(mEntries.begin(), mEntries.end(), time,
+                                  [](const Entry& entry, qint64 time){return entry.time < time;});
+    return found - mEntries.begin();
+}
+
+qint64 SessionLog::search(const Query &query, qint64 from, qint64 budget, int maxMatches, std::vector<qint64> &matches)
+{   //append indexes of entries after $from$ matching $query$ to $matches$. Stops after $maxMatches$
+    //or when $budget$ ms are spent, so GUI can call it again from the returned index
+    QElapsedTimer clock;
+    clock.start();
+    flush();
+    QString pattern = query.pattern.pattern();
+    bool literal = !pattern.contains(QRegularExpression("[\\\\^$.|?*+()\\[\\]{}]"))
+            && !(query.pattern.patternOptions() & QRegularExpression::CaseInsensitiveOption);
+    if(literal)
+    {
+        mMatcher.setPattern(pattern.toUtf8());
+    }
+    int found = 0;
+    qint64 i = from;
+    for(; i < size() && found < maxMatches; ++i)
+    {
+        if((i & 255) == 0 && clock.elapsed() >= budget)
+        {
+            break;
+        }
+        const Entry& entry = mEntries[static_cast<size_t>(i)];
+        if((query.kinds & (1u << entry.kind)) == 0)
+        {
+            continue;
+        }
+        if(!pattern.isEmpty())
+        {
+            if(!readBlock(entry.offset, entry.length))
+            {
+                break;
+            }
+            const char* text = mBlock.constData() + (entry.offset - mBlockStart);
+            bool matched = literal ? mMatcher.indexIn(text, static_cast<int>(entry.length)) != -1
+                                   : query.pattern.match(QString::fromUtf8(text, static_cast<int>(entry.length))).hasMatch();
+            if(!matched)
+            {
+                continue;
+            }
+        }
+        matches.push_back(i);
+        ++found;
+    }
+    return i;
+}
+
+QString SessionLog::getKindName(int kind)
+{
+    return kind >= 0 && kind < KindCount ? kindNames[kind] : QString();
+}
+
+QString SessionLog::getDefaultDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation).append("/sessions");
+}
+
+void SessionLog::removeOldSessions(const QString &dir)
+{   //keep the latest session logs in $dir$ within count and size limits. Names have start time, so
+    //reversed order of names is the newest first
+    QFileInfoList logs = QDir(dir).entryInfoList(QStringList() << "session-*.log", QDir::Files, QDir::Name | QDir::Reversed);
+    qint64 total = 0;
+    for(int i = 0; i < logs.size(); ++i)
+    {
+        total += logs[i].size();
+        if(i >= keepSessions || total > keepBytes)
+        {
+            QFile::remove(logs[i].filePath());
+        }
+    }
+}
+
+void SessionLog::writeBatch()
+{   //format and write pending records in worker thread. Previous batch is finished first,
+    //so records keep their order in file
+    finishBatch();
+    if(mPending.empty())
+    {
+        return;
+    }
+    mBatch.swap(mPending);
+    mPendingSize = 0;
+    mBatchWrite = QtConcurrent::run([this]()
+    {
+        QByteArray lines;
+        for(const Record& i : mBatch)
+        {
+            QByteArray line = QString("%1\t%2\t%3\t%4\t").arg(i.time).arg(kindNames[i.kind])
+                    .arg(i.token).arg(i.thread).toUtf8();
+            qint64 offset = mWritten + lines.size() + line.size();
+            QByteArray data = i.text.toUtf8();
+            data.replace('\r', QByteArray());
+            data.replace('\n', "\\n");
+            lines.append(line).append(data).append('\n');
+            mBatchEntries.push_back(Entry{offset, i.time, static_cast<quint32>(data.size()), i.token, i.thread, i.kind});
+        }
+        qint64 written = mWriter.write(lines);
+        mWritten += std::max(written, qint64(0));
+        if(written != lines.size())
+        {   // entries of batch would point to missing text
+            mBatchEntries.clear();
+        }
+    });
+}
+
+void SessionLog::finishBatch()
+{   //wait for batch being written and add its entries to index
+    mBatchWrite.waitForFinished();
+    mEntries.insert(mEntries.end(), mBatchEntries.begin(), mBatchEntries.end());
+    mBatchEntries.clear();
+    mBatch.clear();
+}
+
+bool SessionLog::readBlock(qint64 offset, qint64 length)
+{   //make sure [$offset$, $offset$+$length$) of file is in mBlock. Following entries come with it,
+    //so sequential search reads file by large blocks
+    if(offset >= mBlockStart && offset + length <= mBlockStart + mBlock.size())
+    {
+        return true;
+    }
+    mWriter.flush();
+    if(!mReader.seek(offset))
+    {
+        return false;
+    }
+    mBlock = mReader.read(std::max(blockSize, length));
+    mBlockStart = offset;
+    return mBlock.size() >= length;
+}
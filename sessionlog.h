@@ -0,0 +1,91 @@
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include <QString>
+#include <QByteArray>
+#include <QByteArrayMatcher>
+#include <QRegularExpression>
+#include <QFile>
+#include <QElapsedTimer>
+#include <QFuture>
+
+#include <vector>
+
+#include "mirecord.h"
+
+/* Session log file has a line per record, fields are separated by tabs:
+     time (ms since session start), kind, token, thread, text
+   Token and thread are -1 when record has none, line breaks of text are written as "\n".
+   Index of lines is kept in memory, so filtering by kind and time doesn't touch the file
+   and text is read only for regex search. Records are formatted and written by batches
+   in worker thread, reading functions wait for records appended before them */
+
+class SessionLog
+{
+public:
+    enum Kind{Command, Result, Error, ExecAsync, StatusAsync, NotifyAsync,
+              Console, Target, Log, Event, KindCount};
+    struct Entry
+    {
+        qint64 offset;      // of text in file
+        qint64 time;
+        quint32 length;     // of text in bytes
+        qint32 token;
+        qint32 thread;
+        quint8 kind;
+    };
+    struct Query
+    {
+        quint32 kinds = (1u << KindCount) - 1;   // bit of every kind to show
+        QRegularExpression pattern;             // empty pattern matches everything
+    };
+
+    SessionLog();
+    ~SessionLog();
+    bool open(const QString& fileName);
+    void close();
+    bool isOpen()const;
+    const QString& getFileName()const;
+    qint64 getStartTime()const;
+    void append(Kind kind, const QString& text, int token = -1, int thread = -1);
+    void append(const MiRecord& record, const QString& line);
+    void flush();
+    qint64 size()const;
+    const Entry& at(qint64 index)const;
+    QString readText(qint64 index);
+    qint64 findTime(qint64 time);
+    qint64 search(const Query& query, qint64 from, qint64 budget, int maxMatches, std::vector<qint64>& matches);
+    static QString getKindName(int kind);
+    static QString getDefaultDir();
+    static void removeOldSessions(const QString& dir);
+private:
+    struct Record
+    {   // appended record waiting for its batch to be written
+        qint64 time;
+        QString text;
+        qint32 token;
+        qint32 thread;
+        quint8 kind;
+    };
+    void writeBatch();
+    void finishBatch();
+    bool readBlock(qint64 offset, qint64 length);
+
+    QString mFileName;
+    QFile mWriter;
+    QFile mReader;
+    QElapsedTimer mClock;
+    qint64 mStartTime;
+    qint64 mWritten;        // file size including unflushed data
+    std::vector<Entry> mEntries;
+    std::vector<Record> mPending;   // records of the next batch
+    qint64 mPendingSize;            // characters in mPending
+    std::vector<Record> mBatch;     // records worker thread writes, only it touches mWriter meanwhile
+    std::vector<Entry> mBatchEntries;
+    QFuture<void> mBatchWrite;
+    QByteArray mBlock;      // part of file read by search
+    qint64 mBlockStart;
+    QByteArrayMatcher mMatcher; // pattern without special characters is searched in bytes
+};
+
+#endif // SESSIONLOG_H
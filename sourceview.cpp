@@ -0,0 +1,496 @@
+#include "sourceview.h"
+
+#include <QCursor>
+#include <QFontDatabase>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QSet>
+
+#include <algorithm>
+#include <cstring>
+
+static const int maxPaintedLength = 4096;   // longer lines (generated code) are cut while painting
+static const int commentLookBehind = 500;   // lines scanned back to find unclosed block comment
+static const int tabSize = 4;
+
+SourceView::SourceView(QWidget *parent):
+    QAbstractScrollArea(parent),
+    mData{nullptr},
+    mSize{0},
+    mLineCount{0},
+    mCurrentLine{0},
+    mSelectedLine{0},
+    mMaxLineLength{0},
+    mCommentCacheLine{-1},
+    mCommentCacheState{false}
+{
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    viewport()->setCursor(Qt::IBeamCursor);
+    viewport()->setMouseTracking(true);
+}
+
+bool SourceView::open(const QString &fileName)
+{   // memory-maps $fileName$ and indexes line starts. Text is decoded only for painted lines
+    close();
+    mFile.setFileName(fileName);
+    if(!mFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    mSize = mFile.size();
+    if(mSize > 0)
+    {
+        mData = mFile.map(0, mSize);
+        if(mData == nullptr)
+        {
+            mFile.close();
+            mSize = 0;
+            return false;
+        }
+    }
+    mLineStarts.reserve(static_cast<size_t>(mSize / 32 + 1));
+    mLineStarts.push_back(0);
+    const uchar* position = mData;
+    const uchar* end = mData + mSize;
+    while(position != end
+          && (position = static_cast<const uchar*>(memchr(position, '\n', end - position))) != nullptr)
+    {
+        ++position;
+        mLineStarts.push_back(position - mData);
+    }
+    mLineCount = static_cast<int>(mLineStarts.size());
+    if(mLineCount > 1 && mLineStarts.back() == mSize)
+    {
+        --mLineCount;   // file ends with line break, there is no line after it
+    }
+    mFileName = fileName;
+    updateScrollBars();
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+    viewport()->update();
+    return true;
+}
+
+void SourceView::close()
+{
+    if(mData != nullptr)
+    {
+        mFile.unmap(const_cast<uchar*>(mData));
+        mData = nullptr;
+    }
+    mFile.close();
+    mSize = 0;
+    mLineStarts.clear();
+    mLineStarts.shrink_to_fit();
+    mLineCount = 0;
+    mFileName.clear();
+    mCurrentLine = 0;
+    mSelectedLine = 0;
+    mBreakpointLines.clear();
+    mMaxLineLength = 0;
+    mCommentCacheLine = -1;
+    viewport()->update();
+}
+
+const QString &SourceView::getFileName() const
+{
+    return mFileName;
+}
+
+int SourceView::getLineCount() const
+{
+    return mLineCount;
+}
+
+int SourceView::getSelectedLine() const
+{   // line clicked by user, 0 if nothing is selected
+    return mSelectedLine;
+}
+
+void SourceView::setCurrentLine(int line)
+{   // mark $line$ where target stopped, 0 removes marker
+    mCurrentLine = line;
+    viewport()->update();
+}
+
+void SourceView::setBreakpointLines(const std::set<int> &lines)
+{
+    mBreakpointLines = lines;
+    viewport()->update();
+}
+
+void SourceView::showLine(int line)
+{   // scroll to $line$ if it isn't visible
+    int visible = viewport()->height() / lineHeight();
+    int first = verticalScrollBar()->value();
+    if(line-1 < first || line-1 >= first + visible)
+    {
+        verticalScrollBar()->setValue(line-1 - visible/2);
+    }
+}
+
+QString SourceView::expressionAt(const QPoint &point) const
+{   // identifier under viewport $point$ with members and scopes before it: "a.b", "p->next", "ns::x".
+    // Empty over keywords, literals, comments and punctuation
+    int line = lineAt(point.y());
+    if(line < 1 || line > mLineCount || point.x() < gutterWidth())
+    {
+        return QString();
+    }
+    QString text = lineText(line-1);
+    int charWidth = QFontMetrics(font()).width(QLatin1Char(' '));
+    int column = (point.x() - gutterWidth() - 4 + horizontalScrollBar()->value()) / charWidth;
+    auto isWord = [](QChar ch){return ch.isLetterOrNumber() || ch == '_';};
+    if(column < 0 || column >= text.size() || !isWord(text[column]))
+    {
+        return QString();
+    }
+    bool inComment = false;  // comments opened on earlier lines are missed, scanning back on every move is too slow
+    for(const Token& token : highlight(text, inComment))
+    {
+        if(column >= token.start && column < token.start + token.length)
+        {
+            return QString();
+        }
+    }
+    int start = column;
+    int end = column;
+    while(end < text.size() && isWord(text[end]))
+    {
+        ++end;
+    }
+    while(start > 0 && isWord(text[start-1]))
+    {
+        --start;
+    }
+    while(true)
+    {
+        int separator = start;
+        if(separator >= 1 && text[separator-1] == '.')
+        {
+            separator -= 1;
+        }
+        else if(separator >= 2 && (text.midRef(separator-2, 2) == QLatin1String("->")
+                                   || text.midRef(separator-2, 2) == QLatin1String("::")))
+        {
+            separator -= 2;
+        }
+        else
+        {
+            break;
+        }
+        int wordStart = separator;
+        while(wordStart > 0 && isWord(text[wordStart-1]))
+        {
+            --wordStart;
+        }
+        if(wordStart == separator)
+        {
+            break;
+        }
+        start = wordStart;
+    }
+    return text[start].isDigit() ? QString() : text.mid(start, end - start);
+}
+
+void SourceView::paintEvent(QPaintEvent *)
+{   // only visible lines are decoded and highlighted
+    QPainter painter(viewport());
+    QFontMetrics metrics(font());
+    int height = lineHeight();
+    int charWidth = metrics.width(QLatin1Char(' '));
+    int gutter = gutterWidth();
+    int first = verticalScrollBar()->value();
+    int last = std::min(mLineCount, first + viewport()->height() / height + 1);
+    int left = gutter + 4 - horizontalScrollBar()->value();
+
+    painter.fillRect(viewport()->rect(), palette().base());
+    bool inComment = isInCommentBefore(first);
+    int maxLength = mMaxLineLength;
+    for(int i=first;i<last;++i)
+    {
+        int y = (i-first) * height;
+        int line = i+1;
+        if(line == mCurrentLine)
+        {
+            painter.fillRect(gutter, y, viewport()->width(), height, QColor(255, 255, 170));
+        }
+        else if(line == mSelectedLine)
+        {
+            painter.fillRect(gutter, y, viewport()->width(), height, QColor(232, 242, 254));
+        }
+
+        QString text = lineText(i);
+        maxLength = std::max(maxLength, text.size());
+        std::vector<Token> tokens = highlight(text, inComment);
+        int column = 0;
+        painter.setClipRect(gutter, y, viewport()->width() - gutter, height);
+        auto drawPart = [&](int start, int length, const QColor& color)
+        {
+            painter.setPen(color);
+            painter.drawText(left + start*charWidth, y + metrics.ascent(), text.mid(start, length));
+        };
+        for(const Token& token : tokens)
+        {
+            if(token.start > column)
+            {
+                drawPart(column, token.start - column, palette().text().color());
+            }
+            QColor color;
+            switch(token.kind)
+            {
+            case Keyword: color = Qt::darkBlue; break;
+            case String: color = Qt::darkGreen; break;
+            case Number: color = Qt::darkMagenta; break;
+            case Comment: color = Qt::gray; break;
+            case Preprocessor: color = QColor(128, 64, 0); break;
+            default: color = palette().text().color();
+            }
+            drawPart(token.start, token.length, color);
+            column = token.start + token.length;
+        }
+        if(column < text.size())
+        {
+            drawPart(column, text.size() - column, palette().text().color());
+        }
+        painter.setClipping(false);
+    }
+
+    /* gutter with line numbers, breakpoints and current line */
+    painter.fillRect(0, 0, gutter, viewport()->height(), palette().window());
+    for(int i=first;i<last;++i)
+    {
+        int y = (i-first) * height;
+        int line = i+1;
+        painter.setPen(palette().windowText().color());
+        painter.drawText(QRect(0, y, gutter - 4, height), Qt::AlignRight | Qt::AlignVCenter, QString::number(line));
+        int marker = height - 4;
+        if(mBreakpointLines.count(line) != 0)
+        {
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(Qt::red);
+            painter.drawEllipse(2, y + 2, marker, marker);
+        }
+        if(line == mCurrentLine)
+        {
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(QColor(255, 200, 0));
+            QPoint arrow[3] = {QPoint(2, y + 2), QPoint(2 + marker, y + height/2), QPoint(2, y + height - 2)};
+            painter.drawPolygon(arrow, 3);
+        }
+    }
+    if(maxLength > mMaxLineLength)
+    {
+        mMaxLineLength = maxLength;
+        updateScrollBars();
+    }
+}
+
+void SourceView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void SourceView::mousePressEvent(QMouseEvent *event)
+{   // click on gutter toggles breakpoint, click on text selects line
+    int line = lineAt(event->y());
+    if(line < 1 || line > mLineCount)
+    {
+        return;
+    }
+    if(event->x() < gutterWidth())
+    {
+        emit signalGutterClicked(line);
+        return;
+    }
+    mSelectedLine = line;
+    viewport()->update();
+}
+
+void SourceView::mouseMoveEvent(QMouseEvent *event)
+{
+    QString expression = expressionAt(event->pos());
+    if(expression != mHoverExpression)
+    {
+        mHoverExpression = expression;
+        emit signalHover(expression, event->globalPos());
+    }
+}
+
+void SourceView::leaveEvent(QEvent *event)
+{
+    QAbstractScrollArea::leaveEvent(event);
+    if(!mHoverExpression.isEmpty())
+    {
+        mHoverExpression.clear();
+        emit signalHover(QString(), QCursor::pos());
+    }
+}
+
+QString SourceView::lineText(int index) const
+{   // decode line $index$ (from 0) from mapped file
+    if(mData == nullptr || index < 0 || index >= mLineCount)
+    {
+        return QString();
+    }
+    qint64 start = mLineStarts[index];
+    qint64 end = index+1 < static_cast<int>(mLineStarts.size()) ? mLineStarts[index+1]-1 : mSize;
+    while(end > start && mData[end-1] == '\r')
+    {
+        --end;
+    }
+    int length = static_cast<int>(std::min<qint64>(end - start, maxPaintedLength));
+    QString text = QString::fromUtf8(reinterpret_cast<const char*>(mData + start), length);
+    return text.replace('\t', QString(tabSize, ' '));
+}
+
+std::vector<SourceView::Token> SourceView::highlight(const QString &text, bool &inComment) const
+{   // split C++ line to colored tokens. $inComment$ carries block comment state between lines
+    static const QSet<QString> keywords{
+        "alignas", "alignof", "auto", "bool", "break", "case", "catch", "char", "class", "const",
+        "constexpr", "const_cast", "continue", "decltype", "default", "delete", "do", "double",
+        "dynamic_cast", "else", "enum", "explicit", "extern", "false", "float", "for", "friend",
+        "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "nullptr",
+        "operator", "override", "private", "protected", "public", "register", "reinterpret_cast",
+        "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct",
+        "switch", "template", "this", "throw", "true", "try", "typedef", "typename", "union",
+        "unsigned", "using", "virtual", "void", "volatile", "while"};
+    std::vector<Token> tokens;
+    int size = text.size();
+    int i = 0;
+    if(inComment)
+    {
+        int end = text.indexOf("*/");
+        if(end == -1)
+        {
+            tokens.push_back(Token{0, size, Comment});
+            return tokens;
+        }
+        tokens.push_back(Token{0, end+2, Comment});
+        i = end+2;
+        inComment = false;
+    }
+    int firstChar = i;
+    while(firstChar < size && text[firstChar].isSpace())
+    {
+        ++firstChar;
+    }
+    if(firstChar < size && text[firstChar] == '#')
+    {
+        tokens.push_back(Token{firstChar, size - firstChar, Preprocessor});
+        return tokens;
+    }
+    while(i < size)
+    {
+        QChar ch = text[i];
+        QChar next = i+1 < size ? text[i+1] : QChar();
+        if(ch == '/' && next == '/')
+        {
+            tokens.push_back(Token{i, size - i, Comment});
+            break;
+        }
+        if(ch == '/' && next == '*')
+        {
+            int end = text.indexOf("*/", i+2);
+            if(end == -1)
+            {
+                tokens.push_back(Token{i, size - i, Comment});
+                inComment = true;
+                break;
+            }
+            tokens.push_back(Token{i, end+2 - i, Comment});
+            i = end+2;
+            continue;
+        }
+        if(ch == '"' || ch == '\'')
+        {
+            int j = i+1;
+            while(j < size && text[j] != ch)
+            {
+                j += text[j] == '\\' ? 2 : 1;
+            }
+            j = std::min(j+1, size);
+            tokens.push_back(Token{i, j - i, String});
+            i = j;
+            continue;
+        }
+        if(ch.isDigit())
+        {
+            int j = i;
+            while(j < size && (text[j].isLetterOrNumber() || text[j] == '.' || text[j] == '\''))
+            {
+                ++j;
+            }
+            tokens.push_back(Token{i, j - i, Number});
+            i = j;
+            continue;
+        }
+        if(ch.isLetter() || ch == '_')
+        {
+            int j = i;
+            while(j < size && (text[j].isLetterOrNumber() || text[j] == '_'))
+            {
+                ++j;
+            }
+            if(keywords.contains(text.mid(i, j - i)))
+            {
+                tokens.push_back(Token{i, j - i, Keyword});
+            }
+            i = j;
+            continue;
+        }
+        ++i;
+    }
+    return tokens;
+}
+
+bool SourceView::isInCommentBefore(int index) const
+{   // block comment state at the beginning of line $index$. Lines before the view are scanned
+    // only up to commentLookBehind back, or from the last painted first line when it is close
+    int start = std::max(0, index - commentLookBehind);
+    bool inComment = false;
+    if(mCommentCacheLine != -1 && mCommentCacheLine <= index && mCommentCacheLine >= start)
+    {
+        start = mCommentCacheLine;
+        inComment = mCommentCacheState;
+    }
+    for(int i=start;i<index;++i)
+    {
+        highlight(lineText(i), inComment);
+    }
+    mCommentCacheLine = index;
+    mCommentCacheState = inComment;
+    return inComment;
+}
+
+void SourceView::updateScrollBars()
+{
+    int height = lineHeight();
+    int visible = std::max(1, viewport()->height() / height);
+    verticalScrollBar()->setRange(0, std::max(0, mLineCount - visible));
+    verticalScrollBar()->setPageStep(visible);
+    verticalScrollBar()->setSingleStep(1);
+    int charWidth = QFontMetrics(font()).width(QLatin1Char(' '));
+    int textWidth = viewport()->width() - gutterWidth();
+    horizontalScrollBar()->setRange(0, std::max(0, mMaxLineLength * charWidth - textWidth + 8));
+    horizontalScrollBar()->setPageStep(textWidth);
+    horizontalScrollBar()->setSingleStep(charWidth);
+}
+
+int SourceView::gutterWidth() const
+{   // marker column and line numbers
+    int digits = std::max(3, QString::number(mLineCount).size());
+    return lineHeight() + digits * QFontMetrics(font()).width(QLatin1Char('9')) + 8;
+}
+
+int SourceView::lineHeight() const
+{
+    return QFontMetrics(font()).height() + 2;
+}
+
+int SourceView::lineAt(int y) const
+{   // line number (from 1) at viewport coordinate $y$
+    return verticalScrollBar()->value() + y / lineHeight() + 1;
+}
@@ -0,0 +1,69 @@
+#ifndef SOURCEVIEW_H
+#define SOURCEVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QFile>
+#include <QString>
+
+#include <set>
+#include <vector>
+
+class SourceView : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    explicit SourceView(QWidget* parent = 0);
+    bool open(const QString& fileName);
+    void close();
+    const QString& getFileName()const;
+    int getLineCount()const;
+    int getSelectedLine()const;
+    void setCurrentLine(int line);
+    void setBreakpointLines(const std::set<int>& lines);
+    void showLine(int line);
+    QString expressionAt(const QPoint& point)const;
+
+signals:
+    void signalGutterClicked(int line);
+    void signalHover(const QString& expression, const QPoint& position);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void leaveEvent(QEvent* event) override;
+
+private:
+    enum TokenKind{Plain, Keyword, String, Number, Comment, Preprocessor};
+    struct Token
+    {
+        int start;
+        int length;
+        TokenKind kind;
+    };
+
+    QString lineText(int index)const;
+    std::vector<Token> highlight(const QString& text, bool& inComment)const;
+    bool isInCommentBefore(int index)const;
+    void updateScrollBars();
+    int gutterWidth()const;
+    int lineHeight()const;
+    int lineAt(int y)const;
+
+    QFile mFile;
+    const uchar* mData;
+    qint64 mSize;
+    std::vector<qint64> mLineStarts;
+    int mLineCount;
+    QString mFileName;
+    int mCurrentLine;   // line where target stopped, 0 if there is no such line
+    int mSelectedLine;
+    std::set<int> mBreakpointLines;
+    int mMaxLineLength;
+    mutable int mCommentCacheLine;  // block comment state at the start of this line is known
+    mutable bool mCommentCacheState;
+    QString mHoverExpression;   // expression under mouse, signal is sent when it changes
+};
+
+#endif // SOURCEVIEW_H
@@ -0,0 +1,313 @@
+#include "startup.h"
+
+#include <QDebug>
+
+static const int localMaxInFlight = 4;
+static const int remoteMaxInFlight = 16;   // every command waits for round trips to gdbserver, keep GDB busy
+
+Startup::Startup(Gdb *gdb, QObject *parent):
+    QObject(parent),
+    mGdb{gdb},
+    mState{Idle},
+    mSkipInitFiles{true},
+    mUseIndexCache{true},
+    mAttachPid{0},
+    mPacketSize{0},
+    mLocalSysroot{true},
+    mPhaseStart{0}
+{
+    connect(mGdb, SIGNAL(started()), this, SLOT(slotStarted()), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(errorOccurred(QProcess::ProcessError)), this, SLOT(slotProcessError(QProcess::ProcessError)), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalConsoleOutput(QString)), this, SLOT(slotConsoleOutput(QString)), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalNotification(MiRecord)), this, SLOT(slotNotification(MiRecord)), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalStopped(MiRecord)), this, SLOT(slotStopped(MiRecord)), Qt::UniqueConnection);
+}
+
+void Startup::setSkipInitFiles(bool skip)
+{   // don't read .gdbinit files, they may load slow scripts
+    mSkipInitFiles = skip;
+}
+
+void Startup::setUseIndexCache(bool use)
+{   // let GDB save symbol index of binary and reuse it next time
+    mUseIndexCache = use;
+}
+
+void Startup::setInferiorTty(const QString &tty)
+{   // terminal for output of program. Without it program gets its own console where possible
+    mInferiorTty = tty;
+}
+
+void Startup::setRemote(const QString &address, int pid)
+{   // debug through gdbserver at $address$ instead of local target. With $pid$ gdbserver attaches
+    // to running process, otherwise it launches executable. Empty $address$ returns to local target
+    mRemoteAddress = address;
+    mAttachPid = pid;
+}
+
+void Startup::setPacketSize(int size)
+{   // bytes of memory moved by one remote packet, 0 leaves size gdbserver offers
+    mPacketSize = size;
+}
+
+void Startup::setLocalSysroot(bool local)
+{   // gdbserver runs on this machine, so shared libraries are read from disk instead of remote protocol
+    mLocalSysroot = local;
+}
+
+bool Startup::isRemote() const
+{
+    return !mRemoteAddress.isEmpty();
+}
+
+QStringList Startup::getArguments() const
+{
+    QStringList arguments;
+    arguments << "--interpreter=mi" << "-q";
+    if(mSkipInitFiles)
+    {
+        arguments << "-nx";
+    }
+    if(mUseIndexCache)
+    {
+        arguments << "-iex" << "set index-cache on";
+    }
+    return arguments;
+}
+
+void Startup::start(const QString &executable, const QStringList &breakpoints)
+{   // launch GDB, load $executable$, set $breakpoints$ and run. Every step waits for GDB
+    // asynchronously, so window stays responsive while symbols are read
+    mExecutable = executable;
+    mBreakpoints = breakpoints;
+    mPhaseTimes.clear();
+    mPhaseStart = 0;
+    mClock.start();
+    if(mGdb->state() == QProcess::Running)
+    {   // switch target of running GDB, e.g. from local one to gdbserver
+        loadTarget();
+        return;
+    }
+    setState(Launching, tr("Starting GDB"));
+    try
+    {
+        mGdb->start(getArguments());
+    }
+    catch(std::exception& exc)
+    {
+        fail(exc.what());
+    }
+}
+
+Startup::State Startup::getState() const
+{
+    return mState;
+}
+
+const QString &Startup::getExecutable() const
+{
+    return mExecutable;
+}
+
+void Startup::slotStarted()
+{
+    if(mState != Launching)
+    {
+        return;
+    }
+    markPhase("launch");
+    loadTarget();
+}
+
+void Startup::loadTarget()
+{
+    if(isRemote())
+    {
+        connectRemote();
+    }
+    else
+    {
+        loadLocal();
+    }
+}
+
+void Startup::loadLocal()
+{
+    setState(LoadingSymbols, tr("Reading symbols from %1").arg(mExecutable));
+    mGdb->getScheduler().setMaxInFlight(localMaxInFlight);
+    if(!mInferiorTty.isEmpty())
+    {
+        mGdb->sendCommand(QString("-inferior-tty-set %1").arg(mInferiorTty));
+    }
+#ifdef Q_OS_WIN
+    else
+    {
+        mGdb->sendCommand("-gdb-set new-console on");
+    }
+#endif
+    mGdb->sendCommand(QString("-file-exec-and-symbols %1").arg(MiRecord::quote(mExecutable)), [this](const MiRecord& record)
+    {
+        if(record.getClass() != "done")
+        {
+            fail(record["msg"].getString());
+            return;
+        }
+        markPhase("symbols");
+        startInferior();
+    });
+}
+
+void Startup::connectRemote()
+{   // every packet is a round trip to gdbserver, so memory is moved by large packets, read-only
+    // sections and libraries are read from local files and more refresh commands are queued in GDB
+    setState(LoadingSymbols, tr("Connecting to %1").arg(mRemoteAddress));
+    mGdb->getScheduler().setMaxInFlight(remoteMaxInFlight);
+    if(mPacketSize > 0)
+    {
+        mGdb->sendCommand(QString("-gdb-set remote memory-read-packet-size %1").arg(mPacketSize));
+        mGdb->sendCommand(QString("-gdb-set remote memory-write-packet-size %1").arg(mPacketSize));
+    }
+    mGdb->sendCommand("-gdb-set trust-readonly-sections on");
+    mGdb->sendCommand("-gdb-set stack-cache on");
+    mGdb->sendCommand("-gdb-set code-cache on");
+    if(mLocalSysroot)
+    {
+        mGdb->sendCommand("-gdb-set sysroot /");
+    }
+    if(mExecutable.isEmpty())
+    {   // attaching without local symbols is allowed, GDB may get them from gdbserver
+        selectRemoteTarget();
+        return;
+    }
+    mGdb->sendCommand(QString("-file-exec-and-symbols %1").arg(MiRecord::quote(mExecutable)), [this](const MiRecord& record)
+    {
+        if(record.getClass() != "done")
+        {
+            fail(record["msg"].getString());
+            return;
+        }
+        markPhase("symbols");
+        selectRemoteTarget();
+    });
+}
+
+void Startup::selectRemoteTarget()
+{   // connect to gdbserver, then launch executable or attach to process
+    mGdb->sendCommand(QString("-target-select extended-remote %1").arg(mRemoteAddress), [this](const MiRecord& record)
+    {
+        if(record.getClass() != "connected" && record.getClass() != "done")
+        {
+            fail(record["msg"].getString());
+            return;
+        }
+        markPhase("connect");
+        if(mAttachPid == 0)
+        {
+            mGdb->sendCommand(QString("-gdb-set remote exec-file %1").arg(MiRecord::quote(mExecutable)));
+            startInferior();
+            return;
+        }
+        // attach stops process, that stop ends startup
+        setState(Running, tr("Attaching to %1").arg(mAttachPid));
+        mGdb->sendCommand(QString("-target-attach %1").arg(mAttachPid), [this](const MiRecord& record)
+        {
+            if(record.getClass() != "done")
+            {
+                fail(record["msg"].getString());
+                return;
+            }
+            for(const QString& i : mBreakpoints)
+            {
+                mGdb->insertBreakpoint(i);
+            }
+        });
+    });
+}
+
+void Startup::startInferior()
+{
+    for(const QString& i : mBreakpoints)
+    {
+        mGdb->insertBreakpoint(i);
+    }
+    mGdb->sendCommand("-exec-run", [this](const MiRecord& record)
+    {
+        if(record.getClass() != "running")
+        {
+            fail(record["msg"].getString());
+            return;
+        }
+        markPhase("run");
+        setState(Running, tr("Running %1").arg(mExecutable));
+    });
+}
+
+void Startup::slotProcessError(QProcess::ProcessError error)
+{
+    if(mState == Launching && error == QProcess::FailedToStart)
+    {
+        fail(tr("GDB failed to start"));
+    }
+}
+
+void Startup::slotConsoleOutput(const QString &text)
+{   // "Reading symbols from ...", "Downloading separate debug info ..." and so on. After program
+    // started only symbol loading of shared libraries is reported, not output of user commands
+    QString line = text.trimmed();
+    if(mState == LoadingSymbols
+            || (mState == Running && (line.startsWith("Reading symbols from") || line.startsWith("Downloading"))))
+    {
+        emit signalProgress(line);
+    }
+}
+
+void Startup::slotNotification(const MiRecord &record)
+{
+    if(mState != Running)
+    {
+        return;
+    }
+    if(record.getClass() == "library-loaded")
+    {
+        emit signalProgress(tr("Loaded symbols for %1").arg(record["target-name"].getString()));
+    }
+    else if(record.getClass() == "thread-group-started")
+    {
+        markPhase("process");
+        emit signalProgress(tr("Process %1 started").arg(record["pid"].getString()));
+    }
+}
+
+void Startup::slotStopped(const MiRecord &record)
+{   // the first stop ends startup, its duration is logged to notice regressions
+    if(mState != Running)
+    {
+        return;
+    }
+    markPhase(record["reason"].getString());
+    qint64 elapsed = mClock.elapsed();
+    qDebug() << "Startup of" << mExecutable << "took" << elapsed << "ms:" << mPhaseTimes.join(", ");
+    setState(Finished, tr("First stop after %1 ms (%2)").arg(elapsed).arg(mPhaseTimes.join(", ")));
+    emit signalFinished(elapsed);
+}
+
+void Startup::setState(Startup::State state, const QString &message)
+{
+    mState = state;
+    emit signalProgress(message);
+}
+
+void Startup::fail(const QString &error)
+{
+    markPhase("failed");
+    qDebug() << "Startup of" << mExecutable << "failed:" << error << mPhaseTimes.join(", ");
+    mState = Failed;
+    emit signalFailed(error);
+}
+
+void Startup::markPhase(const QString &name)
+{   // remember how long the last phase took
+    qint64 now = mClock.elapsed();
+    mPhaseTimes << QString("%1 %2 ms").arg(name).arg(now - mPhaseStart);
+    mPhaseStart = now;
+}
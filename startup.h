@@ -0,0 +1,67 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QStringList>
+
+#include "gdb.h"
+
+class Startup : public QObject
+{
+    Q_OBJECT
+public:
+    enum State{Idle, Launching, LoadingSymbols, Running, Finished, Failed};
+    explicit Startup(Gdb* gdb, QObject* parent = 0);
+    void setSkipInitFiles(bool skip);
+    void setUseIndexCache(bool use);
+    void setInferiorTty(const QString& tty);
+    void setRemote(const QString& address, int pid = 0);
+    void setPacketSize(int size);
+    void setLocalSysroot(bool local);
+    bool isRemote()const;
+    QStringList getArguments()const;
+    void start(const QString& executable, const QStringList& breakpoints);
+    State getState()const;
+    const QString& getExecutable()const;
+
+signals:
+    void signalProgress(const QString& message);
+    void signalFinished(qint64 elapsed);
+    void signalFailed(const QString& error);
+
+private slots:
+    void slotStarted();
+    void slotProcessError(QProcess::ProcessError error);
+    void slotConsoleOutput(const QString& text);
+    void slotNotification(const MiRecord& record);
+    void slotStopped(const MiRecord& record);
+
+private:
+    void setState(State state, const QString& message);
+    void fail(const QString& error);
+    void markPhase(const QString& name);
+    void loadTarget();
+    void loadLocal();
+    void connectRemote();
+    void selectRemoteTarget();
+    void startInferior();
+
+    Gdb* mGdb;
+    State mState;
+    bool mSkipInitFiles;
+    bool mUseIndexCache;
+    QString mInferiorTty;
+    QString mRemoteAddress;     // host:port of gdbserver --multi, empty for local target
+    int mAttachPid;             // process gdbserver attaches to, 0 to let it launch executable
+    int mPacketSize;
+    bool mLocalSysroot;
+    QString mExecutable;
+    QStringList mBreakpoints;
+    QElapsedTimer mClock;
+    qint64 mPhaseStart;
+    QStringList mPhaseTimes;
+};
+
+#endif // STARTUP_H
@@ -0,0 +1,327 @@
+#include "statesnapshot.h"
+
+#include <QSaveFile>
+#include <QDateTime>
+#include <QHash>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+static const char snapshotMagic[] = "UDSS";
+static const quint32 snapshotVersion = 1;
+static const int headerSize = 32;
+static const int recordSize = 24;   // 6 x quint32
+static const int maxVariableDepth = 16;
+
+enum Field{PathField, TypeField, ValueField};
+
+static int compareBytes(const char* a, quint32 aSize, const char* b, quint32 bSize)
+{
+    int result = std::memcmp(a, b, std::min(aSize, bSize));
+    if(result != 0)
+    {
+        return result;
+    }
+    return aSize < bSize ? -1 : (aSize > bSize ? 1 : 0);
+}
+
+void StateSnapshotWriter::addVariable(const QString &prefix, const Variable &var, int depth)
+{   //add $var$ and fields GDB printed in its content. Nested names are "parent.field" already
+    QString content = var.getContent();
+    std::vector<Variable> nested = depth < maxVariableDepth ? var.getNestedTypes() : std::vector<Variable>();
+    addRecord(prefix + var.getName(), var.getType(), nested.empty() ? content : QString());
+    for(const Variable& i : nested)
+    {
+        addVariable(prefix, i, depth+1);
+    }
+}
+
+void StateSnapshotWriter::addBreakpoint(const Breakpoint &breakpoint)
+{   //breakpoint is identified by location, numbers differ from run to run
+    QString value = QString("enabled=%1 hits=%2 ignore=%3 condition=%4")
+            .arg(breakpoint.isEnabled() ? "y" : "n")
+            .arg(breakpoint.getHitCount())
+            .arg(breakpoint.getIgnoreCount())
+            .arg(breakpoint.getCondition());
+    addRecord(QString("breakpoints/%1").arg(breakpoint.getLocation()), "breakpoint", value);
+}
+
+void StateSnapshotWriter::addThreads(const std::vector<SnapshotThread> &threads)
+{   //numbers are padded, so records of threads and frames are sorted in natural order
+    for(const SnapshotThread& thread : threads)
+    {
+        QString threadPath = QString("threads/%1").arg(thread.id, 5, 10, QChar('0'));
+        addRecord(threadPath, "thread", thread.targetId);
+        for(const SnapshotFrame& frame : thread.frames)
+        {
+            QString framePath = QString("%1/%2").arg(threadPath).arg(frame.level, 4, 10, QChar('0'));
+            QString location = frame.file.isEmpty() ? QString("0x%1").arg(frame.address, 0, 16)
+                                                    : QString("%1:%2").arg(frame.file).arg(frame.line);
+            addRecord(framePath, frame.function, location);
+            for(const SnapshotVariable& i : frame.variables)
+            {
+                addVariable(framePath + "/", Variable(i.name, i.type, i.value));
+            }
+        }
+    }
+}
+
+void StateSnapshotWriter::addRecord(const QString &path, const QString &type, const QString &value)
+{
+    mRecords.push_back({path.toUtf8(), type.toUtf8(), value.toUtf8()});
+}
+
+int StateSnapshotWriter::size() const
+{
+    return static_cast<int>(mRecords.size());
+}
+
+bool StateSnapshotWriter::save(const QString &fileName)
+{   //sort records by path and write them. Types repeat a lot, so each is stored once
+    std::stable_sort(mRecords.begin(), mRecords.end(), [](const Record& a, const Record& b)
+    {
+        return compareBytes(a.path.constData(), a.path.size(), b.path.constData(), b.path.size()) < 0;
+    });
+    QByteArray table(static_cast<int>(mRecords.size())*recordSize, '\0');
+    QByteArray strings;
+    QHash<QByteArray, quint32> types;
+    uchar* position = reinterpret_cast<uchar*>(table.data());
+    auto put = [&position](quint32 offset, int size)
+    {
+        qToLittleEndian<quint32>(offset, position);
+        qToLittleEndian<quint32>(static_cast<quint32>(size), position+4);
+        position += 8;
+    };
+    for(const Record& i : mRecords)
+    {
+        put(static_cast<quint32>(strings.size()), i.path.size());
+        strings.append(i.path);
+        auto type = types.find(i.type);
+        if(type == types.end())
+        {
+            type = types.insert(i.type, static_cast<quint32>(strings.size()));
+            strings.append(i.type);
+        }
+        put(type.value(), i.type.size());
+        put(static_cast<quint32>(strings.size()), i.value.size());
+        strings.append(i.value);
+    }
+
+    QByteArray header(headerSize, '\0');
+    uchar* data = reinterpret_cast<uchar*>(header.data());
+    std::memcpy(data, snapshotMagic, 4);
+    qToLittleEndian<quint32>(snapshotVersion, data+4);
+    qToLittleEndian<quint32>(static_cast<quint32>(mRecords.size()), data+8);
+    qToLittleEndian<quint64>(static_cast<quint64>(headerSize + table.size()), data+16);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), data+24);
+
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    file.write(header);
+    file.write(table);
+    file.write(strings);
+    return file.commit();
+}
+
+StateSnapshotFile::StateSnapshotFile():
+    mData{nullptr},
+    mSize{0},
+    mCount{0},
+    mRecords{nullptr},
+    mStrings{nullptr},
+    mStringsSize{0},
+    mCreationTime{0}
+{
+}
+
+bool StateSnapshotFile::open(const QString &fileName)
+{   //map $fileName$ into memory. Nothing is read until records are accessed
+    close();
+    mFile.setFileName(fileName);
+    if(!mFile.open(QIODevice::ReadOnly))
+    {
+        mError = mFile.errorString();
+        return false;
+    }
+    mSize = mFile.size();
+    mData = mSize >= headerSize ? mFile.map(0, mSize) : nullptr;
+    if(mData == nullptr || std::memcmp(mData, snapshotMagic, 4) != 0)
+    {
+        close();
+        mError = QObject::tr("%1 is not a snapshot").arg(fileName);
+        return false;
+    }
+    quint32 version = qFromLittleEndian<quint32>(mData+4);
+    if(version != snapshotVersion)
+    {
+        close();
+        mError = QObject::tr("Snapshot version %1 is not supported").arg(version);
+        return false;
+    }
+    mCount = qFromLittleEndian<quint32>(mData+8);
+    quint64 stringsOffset = qFromLittleEndian<quint64>(mData+16);
+    if(stringsOffset != headerSize + static_cast<quint64>(mCount)*recordSize
+            || stringsOffset > static_cast<quint64>(mSize))
+    {
+        close();
+        mError = QObject::tr("Snapshot %1 is damaged").arg(fileName);
+        return false;
+    }
+    mCreationTime = qFromLittleEndian<qint64>(mData+24);
+    mRecords = mData + headerSize;
+    mStrings = mData + stringsOffset;
+    mStringsSize = mSize - static_cast<qint64>(stringsOffset);
+    return true;
+}
+
+void StateSnapshotFile::close()
+{
+    if(mData != nullptr)
+    {
+        mFile.unmap(const_cast<uchar*>(mData));
+    }
+    mFile.close();
+    mData = nullptr;
+    mSize = 0;
+    mCount = 0;
+    mRecords = nullptr;
+    mStrings = nullptr;
+    mStringsSize = 0;
+    mCreationTime = 0;
+}
+
+const QString &StateSnapshotFile::getError() const
+{
+    return mError;
+}
+
+int StateSnapshotFile::size() const
+{
+    return static_cast<int>(mCount);
+}
+
+qint64 StateSnapshotFile::getCreationTime() const
+{
+    return mCreationTime;
+}
+
+QByteArray StateSnapshotFile::getPath(int index) const
+{
+    return getString(index, PathField);
+}
+
+QByteArray StateSnapshotFile::getType(int index) const
+{
+    return getString(index, TypeField);
+}
+
+QByteArray StateSnapshotFile::getValue(int index) const
+{
+    return getString(index, ValueField);
+}
+
+qint64 StateSnapshotFile::diff(const StateSnapshotFile &before, const StateSnapshotFile &after,
+                               const ChangeHandler &handler)
+{   //walk both files at once like merge of sorted lists and pass every difference to $handler$.
+    //Only changed records are turned into byte arrays. Returns number of reported changes
+    qint64 changes = 0;
+    int i = 0;
+    int j = 0;
+    quint32 size[2][3];
+    const char* text[2][3];
+    auto read = [](const StateSnapshotFile& file, int index, const char** text, quint32* size)
+    {
+        const uchar* record = file.mRecords + static_cast<qint64>(index)*recordSize;
+        for(int field = PathField; field <= ValueField; ++field)
+        {
+            quint32 offset = qFromLittleEndian<quint32>(record + field*8);
+            size[field] = qFromLittleEndian<quint32>(record + field*8 + 4);
+            if(static_cast<qint64>(offset) + size[field] > file.mStringsSize)
+            {
+                size[field] = 0;
+                offset = 0;
+            }
+            text[field] = reinterpret_cast<const char*>(file.mStrings) + offset;
+        }
+    };
+    while(i < before.size() || j < after.size())
+    {
+        if(i < before.size())
+        {
+            read(before, i, text[0], size[0]);
+        }
+        if(j < after.size())
+        {
+            read(after, j, text[1], size[1]);
+        }
+        int order = i == before.size() ? 1 : (j == after.size() ? -1 :
+                    compareBytes(text[0][PathField], size[0][PathField], text[1][PathField], size[1][PathField]));
+        Change change;
+        if(order < 0)
+        {
+            change.kind = Change::Removed;
+            change.path = before.getPath(i);
+            change.oldType = before.getType(i);
+            change.oldValue = before.getValue(i);
+            ++i;
+        }
+        else if(order > 0)
+        {
+            change.kind = Change::Added;
+            change.path = after.getPath(j);
+            change.newType = after.getType(j);
+            change.newValue = after.getValue(j);
+            ++j;
+        }
+        else
+        {
+            bool same = compareBytes(text[0][TypeField], size[0][TypeField], text[1][TypeField], size[1][TypeField]) == 0
+                    && compareBytes(text[0][ValueField], size[0][ValueField], text[1][ValueField], size[1][ValueField]) == 0;
+            if(same)
+            {
+                ++i;
+                ++j;
+                continue;
+            }
+            change.kind = Change::Changed;
+            change.path = after.getPath(j);
+            change.oldType = before.getType(i);
+            change.oldValue = before.getValue(i);
+            change.newType = after.getType(j);
+            change.newValue = after.getValue(j);
+            ++i;
+            ++j;
+        }
+        ++changes;
+        if(!handler(change))
+        {
+            break;
+        }
+    }
+    return changes;
+}
+
+quint32 StateSnapshotFile::getVersion()
+{
+    return snapshotVersion;
+}
+
+QByteArray StateSnapshotFile::getString(int index, int field) const
+{   //view into mapped file without copying
+    if(index < 0 || index >= size())
+    {
+        return QByteArray();
+    }
+    const uchar* record = mRecords + static_cast<qint64>(index)*recordSize + field*8;
+    quint32 offset = qFromLittleEndian<quint32>(record);
+    quint32 length = qFromLittleEndian<quint32>(record+4);
+    if(static_cast<qint64>(offset) + length > mStringsSize)
+    {
+        return QByteArray();
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(mStrings) + offset, static_cast<int>(length));
+}
@@ -0,0 +1,82 @@
+#ifndef STATESNAPSHOT_H
+#define STATESNAPSHOT_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+
+#include <functional>
+#include <vector>
+
+#include "variable.h"
+#include "breakpoint.h"
+#include "coresnapshot.h"
+
+/* Snapshot file layout, all numbers are little-endian:
+     header   magic "UDSS", version, record count, reserved, strings offset (64 bit), creation time (64 bit ms)
+     records  count x {path offset, path size, type offset, type size, value offset, value size} sorted by path
+     strings  UTF-8 text the records point to, offsets are relative to strings start
+   Records are flat, variable tree is stored as paths like "locals/list.head", so two files are
+   compared by a single merge pass over mapped records */
+
+class StateSnapshotWriter
+{
+public:
+    void addVariable(const QString& prefix, const Variable& var, int depth = 0);
+    void addBreakpoint(const Breakpoint& breakpoint);
+    void addThreads(const std::vector<SnapshotThread>& threads);
+    void addRecord(const QString& path, const QString& type, const QString& value);
+    int size()const;
+    bool save(const QString& fileName);
+private:
+    struct Record
+    {
+        QByteArray path;
+        QByteArray type;
+        QByteArray value;
+    };
+    std::vector<Record> mRecords;
+};
+
+class StateSnapshotFile
+{   // read-only view of snapshot file mapped into memory
+public:
+    struct Change
+    {
+        enum Kind{Added, Removed, Changed};
+        Kind kind;
+        QByteArray path;        // views into mapped files, valid while both files are open
+        QByteArray oldType;
+        QByteArray oldValue;
+        QByteArray newType;
+        QByteArray newValue;
+    };
+    typedef std::function<bool(const Change&)> ChangeHandler; // returns false to stop diff
+
+    StateSnapshotFile();
+    bool open(const QString& fileName);
+    void close();
+    const QString& getError()const;
+    int size()const;
+    qint64 getCreationTime()const;
+    QByteArray getPath(int index)const;
+    QByteArray getType(int index)const;
+    QByteArray getValue(int index)const;
+    static qint64 diff(const StateSnapshotFile& before, const StateSnapshotFile& after,
+                       const ChangeHandler& handler);
+    static quint32 getVersion();
+private:
+    QByteArray getString(int index, int field)const;
+
+    QFile mFile;
+    const uchar* mData;
+    qint64 mSize;
+    quint32 mCount;
+    const uchar* mRecords;
+    const uchar* mStrings;
+    qint64 mStringsSize;
+    qint64 mCreationTime;
+    QString mError;
+};
+
+#endif // STATESNAPSHOT_H
@@ -0,0 +1,59 @@
+#include "structurewalk.h"
+
+#include "mirecord.h"
+
+StructureWalk::StructureWalk():
+    mTruncated{false}
+{
+}
+
+StructureWalk StructureWalk::parse(const QString &output)
+{   // read output of uidebugger-walk helper command
+    /*
+        walk|3|0
+        node|0|-1||0x602010|1
+        node|1|0|next|0x602030|2
+        ref|2|1|next|0x602010|0
+    */
+    StructureWalk walk;
+    QStringList lines = output.split('\n', QString::SkipEmptyParts);
+    if(lines.isEmpty() || !lines[0].startsWith("walk|"))
+    {
+        return walk;
+    }
+    QStringList header = lines[0].split('|');
+    walk.mTruncated = header.value(2) == "1";
+    walk.mNodes.reserve(header.value(1).toInt());
+    for(int i=1;i<lines.size();++i)
+    {
+        QStringList fields = lines[i].split('|');
+        if(fields.size() < 5)
+        {
+            continue;
+        }
+        Node node{fields[2].toInt(), -1, fields[3], fields[4], QStringList()};
+        if(fields[0] == "ref")
+        {   // values can't mark revisit, reference member prints as "@0x601010: 42" too
+            node.reference = fields.value(5).toInt();
+        }
+        else
+        {
+            for(int field=5;field<fields.size();++field)
+            {
+                node.values << MiRecord::unescapeHelper(fields[field]);
+            }
+        }
+        walk.mNodes.push_back(node);
+    }
+    return walk;
+}
+
+const std::vector<StructureWalk::Node> &StructureWalk::getNodes() const
+{
+    return mNodes;
+}
+
+bool StructureWalk::isTruncated() const
+{   // true if walk stopped at node limit before visiting all nodes
+    return mTruncated;
+}
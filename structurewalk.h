@@ -0,0 +1,30 @@
+#ifndef STRUCTUREWALK_H
+#define STRUCTUREWALK_H
+
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+class StructureWalk
+{
+public:
+    struct Node
+    {
+        int parent;         // index of node this one is linked from, -1 for root
+        int reference;      // index of the first visit if node was reached again, otherwise -1
+        QString link;       // field of parent which points to this node
+        QString address;
+        QStringList values;
+    };
+
+    StructureWalk();
+    static StructureWalk parse(const QString& output);
+    const std::vector<Node>& getNodes()const;
+    bool isTruncated()const;
+private:
+    std::vector<Node> mNodes;
+    bool mTruncated;
+};
+
+#endif // STRUCTUREWALK_H
@@ -0,0 +1,441 @@
+#include "symbolindex.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QHash>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include <cstring>
+#include <limits>
+
+static const quint32 cacheMagic = 0x5553594d; // "USYM"
+static const quint32 cacheVersion = 1;
+
+static int charBit(uchar c)
+{   // letters, digits, '_' and ':' get own bits, the rest share buckets
+    if(c >= 'a' && c <= 'z')
+    {
+        return c - 'a';
+    }
+    if(c >= '0' && c <= '9')
+    {
+        return 26 + c - '0';
+    }
+    if(c == '_')
+    {
+        return 36;
+    }
+    if(c == ':')
+    {
+        return 37;
+    }
+    return 38 + c % 26;
+}
+
+static quint64 charMask(const char* text)
+{
+    quint64 mask = 0;
+    for(; *text; ++text)
+    {
+        mask |= quint64(1) << charBit(static_cast<uchar>(*text));
+    }
+    return mask;
+}
+
+static int matchScore(const char* name, const QByteArray& pattern)
+{   // lower is better, -1 if $pattern$ isn't a subsequence of $name$
+    int length = std::min(static_cast<int>(std::strlen(name)), 999);
+    const char* found = std::strstr(name, pattern.constData());
+    if(found == name)
+    {
+        return name[pattern.size()] == '\0' ? 0 : 1000 + length;
+    }
+    if(found != nullptr)
+    {   // match from start of word is better, i.e. "push" in "std::vector::push_back"
+        char before = found[-1];
+        bool wordStart = before == ':' || before == '_' || before == ' ';
+        return (wordStart ? 2000 : 3000) + length;
+    }
+    int gaps = 0;
+    const char* last = nullptr;
+    const char* position = name;
+    for(char c : pattern)
+    {
+        const char* next = std::strchr(position, c);
+        if(next == nullptr)
+        {
+            return -1;
+        }
+        if(last != nullptr)
+        {
+            gaps += static_cast<int>(next - last) - 1;
+        }
+        last = next;
+        position = next+1;
+    }
+    return 10000 + std::min(gaps, 999)*1000 + length;
+}
+
+static quint32 appendString(QByteArray& pool, const QByteArray& text)
+{
+    quint32 offset = static_cast<quint32>(pool.size());
+    pool.append(text).append('\0');
+    return offset;
+}
+
+std::shared_ptr<SymbolTable> SymbolTable::build(std::vector<Raw> &symbols)
+{   //sort $symbols$ by name and pack them. Duplicates GDB lists for every block are dropped
+    std::vector<QByteArray> lowered;
+    lowered.reserve(symbols.size());
+    for(const Raw& i : symbols)
+    {
+        lowered.push_back(i.name.toLower());
+    }
+    std::vector<int> order(symbols.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int a, int b)
+    {
+        int compare = std::strcmp(lowered[a].constData(), lowered[b].constData());
+        if(compare != 0)
+        {
+            return compare < 0;
+        }
+        return std::tie(symbols[a].name, symbols[a].file, symbols[a].line) <
+                std::tie(symbols[b].name, symbols[b].file, symbols[b].line);
+    });
+
+    std::shared_ptr<SymbolTable> table = std::make_shared<SymbolTable>();
+    table->mEntries.reserve(symbols.size());
+    table->mMasks.reserve(symbols.size());
+    QHash<QByteArray, quint32> files;
+    const Raw* previous = nullptr;
+    for(int i : order)
+    {
+        const Raw& symbol = symbols[i];
+        if(previous != nullptr && previous->name == symbol.name && previous->file == symbol.file
+                && previous->line == symbol.line)
+        {
+            continue;
+        }
+        previous = &symbol;
+        auto file = files.find(symbol.file);
+        if(file == files.end())
+        {
+            file = files.insert(symbol.file, appendString(table->mStrings, symbol.file));
+        }
+        Entry entry;
+        entry.name = appendString(table->mNames, symbol.name);
+        appendString(table->mLowerNames, lowered[i]);
+        entry.file = file.value();
+        entry.description = appendString(table->mStrings, symbol.description);
+        entry.line = symbol.line;
+        entry.function = symbol.function ? 1 : 0;
+        table->mEntries.push_back(entry);
+        table->mMasks.push_back(charMask(lowered[i].constData()));
+    }
+    return table;
+}
+
+std::shared_ptr<SymbolTable> SymbolTable::load(const QString &fileName, const QByteArray &key)
+{   //read table saved by save(). Returns null if file is broken or saved for other $key$
+    QFile file(fileName);
+    if(!file.open(QIODevice::ReadOnly))
+    {
+        return std::shared_ptr<SymbolTable>();
+    }
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    QByteArray savedKey;
+    quint32 count = 0;
+    in >> magic >> version >> savedKey >> count;
+    if(magic != cacheMagic || version != cacheVersion || savedKey != key || in.status() != QDataStream::Ok)
+    {
+        return std::shared_ptr<SymbolTable>();
+    }
+    qint64 rawSize = static_cast<qint64>(count)*static_cast<qint64>(sizeof(Entry) + sizeof(quint64));
+    if(rawSize > file.size() - file.pos() || rawSize > std::numeric_limits<int>::max())
+    {   // count is broken, don't allocate memory for it
+        return std::shared_ptr<SymbolTable>();
+    }
+    std::shared_ptr<SymbolTable> table = std::make_shared<SymbolTable>();
+    table->mEntries.resize(count);
+    table->mMasks.resize(count);
+    int entriesSize = static_cast<int>(count*sizeof(Entry));
+    int masksSize = static_cast<int>(count*sizeof(quint64));
+    if(in.readRawData(reinterpret_cast<char*>(table->mEntries.data()), entriesSize) != entriesSize
+            || in.readRawData(reinterpret_cast<char*>(table->mMasks.data()), masksSize) != masksSize)
+    {
+        return std::shared_ptr<SymbolTable>();
+    }
+    in >> table->mNames >> table->mLowerNames >> table->mStrings;
+    if(in.status() != QDataStream::Ok || table->mNames.size() != table->mLowerNames.size())
+    {
+        return std::shared_ptr<SymbolTable>();
+    }
+    quint32 namesSize = static_cast<quint32>(table->mNames.size());
+    quint32 stringsSize = static_cast<quint32>(table->mStrings.size());
+    for(const Entry& entry : table->mEntries)
+    {   // every offset should point to a string inside its pool, pools end with '\0'
+        if(entry.name >= namesSize || entry.file >= stringsSize || entry.description >= stringsSize)
+        {
+            return std::shared_ptr<SymbolTable>();
+        }
+    }
+    return table;
+}
+
+bool SymbolTable::save(const QString &fileName, const QByteArray &key) const
+{   //arrays are written as is, cache is never moved to other machine
+    QSaveFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+    QDataStream out(&file);
+    out << cacheMagic << cacheVersion << key << static_cast<quint32>(mEntries.size());
+    out.writeRawData(reinterpret_cast<const char*>(mEntries.data()), static_cast<int>(mEntries.size()*sizeof(Entry)));
+    out.writeRawData(reinterpret_cast<const char*>(mMasks.data()), static_cast<int>(mMasks.size()*sizeof(quint64)));
+    out << mNames << mLowerNames << mStrings;
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+std::vector<int> SymbolTable::search(const QString &query, int maxResults) const
+{   //fuzzy search: characters of $query$ should appear in name in the same order, case is ignored.
+    //Exact, prefix and substring matches go first, shorter names before longer ones
+    std::vector<int> result;
+    QByteArray pattern = query.trimmed().toUtf8().toLower();
+    if(pattern.isEmpty() || maxResults <= 0)
+    {
+        return result;
+    }
+    quint64 mask = charMask(pattern.constData());
+    typedef std::pair<int, int> Match; // score and index
+    std::priority_queue<Match> best;   // the worst of kept matches on top
+    for(size_t i = 0; i < mEntries.size(); ++i)
+    {
+        if((mMasks[i] & mask) != mask)
+        {
+            continue;
+        }
+        int score = matchScore(mLowerNames.constData() + mEntries[i].name, pattern);
+        if(score < 0)
+        {
+            continue;
+        }
+        Match match(score, static_cast<int>(i));
+        if(static_cast<int>(best.size()) < maxResults)
+        {
+            best.push(match);
+        }
+        else if(match < best.top())
+        {
+            best.pop();
+            best.push(match);
+        }
+    }
+    result.resize(best.size());
+    for(size_t i = result.size(); i-- > 0; best.pop())
+    {
+        result[i] = best.top().second;
+    }
+    return result;
+}
+
+SymbolInfo SymbolTable::at(int index) const
+{
+    const Entry& entry = mEntries[static_cast<size_t>(index)];
+    SymbolInfo info;
+    info.name = QString::fromUtf8(mNames.constData() + entry.name);
+    info.file = QString::fromUtf8(mStrings.constData() + entry.file);
+    info.line = entry.line;
+    info.description = QString::fromUtf8(mStrings.constData() + entry.description);
+    info.function = entry.function != 0;
+    return info;
+}
+
+int SymbolTable::size() const
+{
+    return static_cast<int>(mEntries.size());
+}
+
+SymbolIndex::SymbolIndex(Gdb *gdb, QObject *parent):
+    QObject(parent),
+    mGdb{gdb},
+    mState{Empty},
+    mFromCache{false}
+{
+    connect(&mWatcher, SIGNAL(finished()), this, SLOT(slotTableReady()), Qt::UniqueConnection);
+}
+
+void SymbolIndex::load(const QString &executable)
+{   //index symbols of $executable$. Index cached for the same binary is reused, otherwise
+    //symbols are listed by GDB, then index is built and saved in background thread
+    if(mState == Loading)
+    {
+        return;
+    }
+    mExecutable = executable;
+    mState = Loading;
+    mClock.start();
+    emit signalProgress(tr("Indexing symbols of %1").arg(executable));
+    mGdb->sendCommand("uidebugger-build-id", [this](const MiRecord& record)
+    {
+        QString buildId;
+        const QString& output = mGdb->getHelperOutput();
+        if(record.getClass() == "done" && output.startsWith("build-id|"))
+        {
+            buildId = output.mid(static_cast<int>(std::strlen("build-id|"))).trimmed();
+        }
+        if(!buildId.isEmpty())
+        {
+            mKey = "build-" + buildId.toLatin1();
+        }
+        else
+        {   // binary without build-id is recognized by path, size and modification time
+            QFileInfo info(mExecutable);
+            QCryptographicHash hash(QCryptographicHash::Sha1);
+            hash.addData(info.absoluteFilePath().toUtf8());
+            hash.addData(QByteArray::number(info.size()));
+            hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+            mKey = "file-" + hash.result().toHex();
+        }
+        mCacheFile = QString("%1/%2.sym").arg(getCacheDir(), QString::fromLatin1(mKey));
+        if(!QFile::exists(mCacheFile))
+        {
+            requestSymbols();
+            return;
+        }
+        mFromCache = true;
+        QString fileName = mCacheFile;
+        QByteArray key = mKey;
+        mWatcher.setFuture(QtConcurrent::run([fileName, key]()
+        {
+            return SymbolTable::load(fileName, key);
+        }));
+    });
+}
+
+SymbolIndex::State SymbolIndex::getState() const
+{
+    return mState;
+}
+
+int SymbolIndex::size() const
+{
+    return mTable ? mTable->size() : 0;
+}
+
+std::vector<SymbolInfo> SymbolIndex::search(const QString &query, int maxResults) const
+{
+    std::vector<SymbolInfo> result;
+    if(!mTable)
+    {
+        return result;
+    }
+    for(int i : mTable->search(query, maxResults))
+    {
+        result.push_back(mTable->at(i));
+    }
+    return result;
+}
+
+QString SymbolIndex::getCacheDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation).append("/symbols");
+}
+
+void SymbolIndex::slotTableReady()
+{
+    std::shared_ptr<SymbolTable> table = mWatcher.result();
+    if(!table)
+    {   // cache is broken or was written by other version
+        requestSymbols();
+        return;
+    }
+    mTable = table;
+    mState = Ready;
+    qDebug() << "Symbol index of" << mExecutable << (mFromCache ? "loaded from cache" : "built")
+             << "with" << mTable->size() << "symbols in" << mClock.elapsed() << "ms";
+    emit signalProgress(tr("%1 symbols indexed in %2 ms").arg(mTable->size()).arg(mClock.elapsed()));
+    emit signalReady(mTable->size());
+}
+
+void SymbolIndex::requestSymbols()
+{   //replies may have a million symbols, so they aren't echoed
+    mFromCache = false;
+    mRaw.clear();
+    emit signalProgress(tr("Listing symbols of %1").arg(mExecutable));
+    mGdb->sendCommand("-symbol-info-functions --include-nondebug", [this](const MiRecord& record)
+    {
+        if(record.getClass() != "done")
+        {
+            fail(record["msg"].getString());
+            return;
+        }
+        collect(record["symbols"], true);
+        mGdb->sendCommand("-symbol-info-variables", [this](const MiRecord& record)
+        {
+            if(record.getClass() == "done")
+            {
+                collect(record["symbols"], false);
+            }
+            std::shared_ptr<std::vector<SymbolTable::Raw>> symbols = std::make_shared<std::vector<SymbolTable::Raw>>();
+            symbols->swap(mRaw);
+            QString fileName = mCacheFile;
+            QByteArray key = mKey;
+            emit signalProgress(tr("Indexing %1 symbols").arg(symbols->size()));
+            mWatcher.setFuture(QtConcurrent::run([symbols, fileName, key]()
+            {
+                std::shared_ptr<SymbolTable> table = SymbolTable::build(*symbols);
+                QDir().mkpath(QFileInfo(fileName).path());
+                if(!table->save(fileName, key))
+                {
+                    qDebug() << "Can't save symbol index to" << fileName;
+                }
+                return table;
+            }));
+        }, false, CommandScheduler::Background);
+    }, false, CommandScheduler::Background);
+}
+
+void SymbolIndex::collect(const MiValue &symbols, bool function)
+{   //symbols={debug=[{fullname,symbols=[{line,name,description}]}],nondebugging=[{address,name}]}
+    const MiValue& debug = symbols["debug"];
+    for(int i = 0; i < debug.size(); ++i)
+    {
+        const MiValue& file = debug.at(i);
+        QByteArray fileName = (file.contains("fullname") ? file["fullname"] : file["filename"]).getString().toUtf8();
+        const MiValue& list = file["symbols"];
+        for(int j = 0; j < list.size(); ++j)
+        {
+            const MiValue& symbol = list.at(j);
+            mRaw.push_back({symbol["name"].getString().toUtf8(), fileName, symbol["description"].getString().toUtf8(),
+                            symbol["line"].getString().toInt(), function});
+        }
+    }
+    const MiValue& nondebugging = symbols["nondebugging"];
+    for(int i = 0; i < nondebugging.size(); ++i)
+    {
+        const MiValue& symbol = nondebugging.at(i);
+        mRaw.push_back({symbol["name"].getString().toUtf8(), QByteArray(), symbol["address"].getString().toUtf8(),
+                        0, function});
+    }
+}
+
+void SymbolIndex::fail(const QString &error)
+{
+    mState = Failed;
+    emit signalProgress(tr("Can't index symbols: %1").arg(error));
+}
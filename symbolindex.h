@@ -0,0 +1,97 @@
+#ifndef SYMBOLINDEX_H
+#define SYMBOLINDEX_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+
+#include <memory>
+#include <vector>
+
+#include "gdb.h"
+
+struct SymbolInfo
+{
+    QString name;
+    QString file;       // empty for symbols without debug info
+    int line;
+    QString description;
+    bool function;
+};
+
+class SymbolTable
+{   // symbols sorted by name in a few flat arrays. Immutable after build, so it's built
+    // and saved in background thread and searched from GUI thread without locks
+public:
+    struct Raw
+    {
+        QByteArray name;
+        QByteArray file;
+        QByteArray description;
+        int line;
+        bool function;
+    };
+
+    static std::shared_ptr<SymbolTable> build(std::vector<Raw>& symbols);
+    static std::shared_ptr<SymbolTable> load(const QString& fileName, const QByteArray& key);
+    bool save(const QString& fileName, const QByteArray& key)const;
+    std::vector<int> search(const QString& query, int maxResults)const;
+    SymbolInfo at(int index)const;
+    int size()const;
+
+private:
+    struct Entry
+    {   // offsets of '\0' terminated strings in pools
+        quint32 name;       // in mNames and mLowerNames
+        quint32 file;       // in mStrings
+        quint32 description;
+        qint32 line;
+        quint32 function;
+    };
+
+    std::vector<Entry> mEntries;    // sorted by lowered name
+    std::vector<quint64> mMasks;    // characters present in each name, to skip most names without comparing
+    QByteArray mNames;
+    QByteArray mLowerNames;         // same layout as mNames, ASCII lowered
+    QByteArray mStrings;
+};
+
+class SymbolIndex : public QObject
+{
+    Q_OBJECT
+public:
+    enum State{Empty, Loading, Ready, Failed};
+    explicit SymbolIndex(Gdb* gdb, QObject* parent = 0);
+    void load(const QString& executable);
+    State getState()const;
+    int size()const;
+    std::vector<SymbolInfo> search(const QString& query, int maxResults = 200)const;
+    static QString getCacheDir();
+
+signals:
+    void signalProgress(const QString& message);
+    void signalReady(int count);
+
+private slots:
+    void slotTableReady();
+
+private:
+    void requestSymbols();
+    void collect(const MiValue& symbols, bool function);
+    void fail(const QString& error);
+
+    Gdb* mGdb;
+    State mState;
+    QString mExecutable;
+    QByteArray mKey;
+    QString mCacheFile;
+    bool mFromCache;
+    std::vector<SymbolTable::Raw> mRaw;
+    std::shared_ptr<const SymbolTable> mTable;
+    QFutureWatcher<std::shared_ptr<SymbolTable>> mWatcher;
+    QElapsedTimer mClock;
+};
+
+#endif // SYMBOLINDEX_H
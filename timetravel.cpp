@@ -0,0 +1,290 @@
+#include "timetravel.h"
+
+#include <QStringList>
+
+TimeTravel::TimeTravel(Gdb *gdb, QObject *parent):
+    QObject(parent),
+    mGdb{gdb},
+    mMode{Off},
+    mInferior{0},
+    mMaxMarks{0}
+{
+    reset();
+    connect(mGdb, SIGNAL(signalStopped(MiRecord)), this, SLOT(slotStopped(MiRecord)), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalBackgroundStopped(MiRecord)), this, SLOT(slotBackgroundStopped(MiRecord)), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalNotification(MiRecord)), this, SLOT(slotNotification(MiRecord)), Qt::UniqueConnection);
+}
+
+void TimeTravel::startRecording(int maxInstructions, int maxMarks)
+{   //record the last $maxInstructions$ instructions, the oldest are dropped instead of stopping target.
+    //Breakpoint hits are marked in log, the last $maxMarks$ of them are kept
+    stop();
+    mMaxMarks = maxMarks;
+    mInferior = mGdb->getInferiors().getFocus();
+    mGdb->sendCommand(QString("-gdb-set record full insn-number-max %1").arg(maxInstructions));
+    mGdb->sendCommand("-gdb-set record full stop-at-limit off");
+    mGdb->sendCommand("record full", [this](const MiRecord& record)
+    {
+        if(record.getClass() != "done")
+        {
+            return;
+        }
+        mMode = Recording;
+        readRecordInfo(QString());
+    });
+}
+
+void TimeTravel::startCheckpoints(int maxCheckpoints)
+{   //fork program at every breakpoint hit, only the last $maxCheckpoints$ forks are kept
+    stop();
+    mMaxMarks = maxCheckpoints;
+    mInferior = mGdb->getInferiors().getFocus();
+    mMode = Checkpoints;
+    emit signalChanged();
+}
+
+void TimeTravel::stop()
+{   //stop recording and delete checkpoints. Target continues from where it is now
+    if(mMode != Off)
+    {
+        selectInferior();
+    }
+    if(mMode == Recording)
+    {
+        mGdb->sendCommand("record stop");
+    }
+    else if(mMode == Checkpoints)
+    {
+        for(const Mark& i : mMarks)
+        {
+            mGdb->sendCommand(QString("delete checkpoint %1").arg(i.id), Gdb::ResultHandler(), false);
+        }
+    }
+    reset();
+    emit signalChanged();
+}
+
+void TimeTravel::rewind(qint64 id)
+{   //return to mark $id$. Recording replays from the logged instruction, checkpoint switches
+    //to its fork, so later checkpoints still lead to the future
+    if(mMode == Off)
+    {
+        return;
+    }
+    selectInferior();
+    QString command = mMode == Recording ? QString("record goto %1").arg(id) : QString("restart %1").arg(id);
+    mGdb->sendCommand(command, [this](const MiRecord& record)
+    {
+        if(record.getClass() != "done")
+        {
+            return;
+        }
+        showFrame();
+        if(mMode == Recording)
+        {
+            readRecordInfo(QString());
+        }
+    }, true, CommandScheduler::Execution);
+}
+
+void TimeTravel::goToPresent()
+{   //leave replay and continue from the end of log
+    if(mMode != Recording || mCurrent == 0)
+    {
+        return;
+    }
+    selectInferior();
+    mGdb->sendCommand("record goto end", [this](const MiRecord& record)
+    {
+        if(record.getClass() == "done")
+        {
+            showFrame();
+            readRecordInfo(QString());
+        }
+    }, true, CommandScheduler::Execution);
+}
+
+TimeTravel::Mode TimeTravel::getMode() const
+{
+    return mMode;
+}
+
+const std::deque<TimeTravel::Mark> &TimeTravel::getMarks() const
+{
+    return mMarks;
+}
+
+qint64 TimeTravel::getRecorded() const
+{
+    return mRecorded;
+}
+
+qint64 TimeTravel::getMaxInstructions() const
+{
+    return mMaxInstructions;
+}
+
+qint64 TimeTravel::getLowest() const
+{
+    return mLowest;
+}
+
+qint64 TimeTravel::getHighest() const
+{
+    return mHighest;
+}
+
+qint64 TimeTravel::getCurrent() const
+{
+    return mCurrent;
+}
+
+void TimeTravel::slotStopped(const MiRecord &record)
+{
+    readStop(record, false);
+}
+
+void TimeTravel::slotBackgroundStopped(const MiRecord &record)
+{   // breakpoint hit in inferior user doesn't look at is marked too
+    readStop(record, true);
+}
+
+void TimeTravel::slotNotification(const MiRecord &record)
+{   // log and forks belong to process which is gone
+    if(record.getClass() == "thread-group-exited" && mMode != Off
+            && Inferiors::parseId(record["id"].getString()) == mInferior)
+    {
+        reset();
+        emit signalChanged();
+    }
+}
+
+void TimeTravel::readStop(const MiRecord &record, bool background)
+{   // marks are made only at breakpoint hits, other stops just update size of log. Stops of other
+    // inferiors are skipped. Background stop is read only to mark it, GDB has its thread selected
+    // only until refreshes of focused inferior
+    /*
+        *stopped,reason="breakpoint-hit",disp="keep",bkptno="1",frame={func="main",file="main.cpp",line="46"},...
+    */
+    int inferior = mGdb->getInferiors().findByThread(record["thread-id"].getString().toInt());
+    if(mMode == Off || (inferior != 0 && inferior != mInferior))
+    {
+        return;
+    }
+    QString location;
+    if(record["reason"].getString() == "breakpoint-hit")
+    {
+        const MiValue& frame = record["frame"];
+        location = frame.contains("file") ? QString("%1 at %2:%3").arg(frame["func"].getString())
+                                            .arg(frame["file"].getString()).arg(frame["line"].getString())
+                                          : frame["func"].getString();
+    }
+    if(background && location.isEmpty())
+    {
+        return;
+    }
+    if(mMode == Recording)
+    {
+        readRecordInfo(location);
+    }
+    else if(!location.isEmpty())
+    {
+        takeCheckpoint(location);
+    }
+}
+
+void TimeTravel::readRecordInfo(const QString &markLocation)
+{   //update numbers of log. With $markLocation$ the current instruction is marked, so it goes
+    //before any resume the user asks for. Plain refresh is dropped when target resumes
+    bool mark = !markLocation.isEmpty();
+    mGdb->sendCommand("uidebugger-record-info", [this, markLocation](const MiRecord& record)
+    {
+        /*
+            record|record-full|1|152|152|200000|0
+        */
+        QStringList fields = mGdb->getHelperOutput().trimmed().split('|');
+        if(record.getClass() != "done" || fields.size() != 7 || fields[0] != "record")
+        {
+            return;
+        }
+        if(fields[1].isEmpty())
+        {   // recording stopped by GDB itself, e.g. on instruction it can't record
+            reset();
+            emit signalChanged();
+            return;
+        }
+        mLowest = fields[2].toLongLong();
+        mHighest = fields[3].toLongLong();
+        mRecorded = fields[4].toLongLong();
+        mMaxInstructions = fields[5].toLongLong();
+        mCurrent = fields[6].toLongLong();
+        while(!mMarks.empty() && mMarks.front().id < mLowest)
+        {   // instructions of these marks are dropped from log already
+            mMarks.pop_front();
+        }
+        if(!markLocation.isEmpty())
+        {
+            addMark(mCurrent != 0 ? mCurrent : mHighest, markLocation);
+        }
+        emit signalChanged();
+    }, false, mark ? CommandScheduler::Interactive : CommandScheduler::View, mark ? QString() : Gdb::getStopGroup());
+}
+
+void TimeTravel::takeCheckpoint(const QString &location)
+{   //fork must be made where target stopped, so it goes before any resume the user asks for
+    mGdb->sendCommand("uidebugger-checkpoint", [this, location](const MiRecord& record)
+    {
+        /*
+            checkpoint|3|12345
+        */
+        QStringList fields = mGdb->getHelperOutput().trimmed().split('|');
+        if(record.getClass() == "done" && fields.size() == 3 && fields[0] == "checkpoint")
+        {
+            addMark(fields[1].toLongLong(), location);
+            emit signalChanged();
+        }
+    }, false, CommandScheduler::Interactive);
+}
+
+void TimeTravel::selectInferior()
+{   // commands go to inferior GDB has selected, it is switched to the one of log or forks
+    if(mGdb->getInferiors().getFocus() != mInferior)
+    {
+        mGdb->focusInferior(mInferior);
+    }
+}
+
+void TimeTravel::addMark(qint64 id, const QString &location)
+{
+    mMarks.push_back(Mark{id, location});
+    while(static_cast<int>(mMarks.size()) > mMaxMarks)
+    {
+        if(mMode == Checkpoints)
+        {   // fork is a whole process, the oldest one is killed
+            mGdb->sendCommand(QString("delete checkpoint %1").arg(mMarks.front().id), Gdb::ResultHandler(), false);
+        }
+        mMarks.pop_front();
+    }
+}
+
+void TimeTravel::showFrame()
+{   // GDB doesn't report stop after switching to another moment, frame is read to show where target is
+    mGdb->sendCommand("-stack-info-frame", [this](const MiRecord& record)
+    {
+        if(record.getClass() == "done")
+        {
+            emit signalRewound(record);
+        }
+    }, false, CommandScheduler::View);
+}
+
+void TimeTravel::reset()
+{
+    mMode = Off;
+    mMarks.clear();
+    mRecorded = 0;
+    mMaxInstructions = 0;
+    mLowest = 0;
+    mHighest = 0;
+    mCurrent = 0;
+}
@@ -0,0 +1,68 @@
+#ifndef TIMETRAVEL_H
+#define TIMETRAVEL_H
+
+#include <QObject>
+#include <QString>
+
+#include <deque>
+
+#include "gdb.h"
+
+class TimeTravel : public QObject
+{   // going back without restarting program. Recording logs every instruction target executes, so it
+    // can run backwards and jump to any logged instruction. Checkpoints fork the program at breakpoint
+    // hits and switch to a fork, they work where recording is too slow but can't step backwards
+    Q_OBJECT
+public:
+    enum Mode{Off, Recording, Checkpoints};
+    struct Mark
+    {
+        qint64 id;          // instruction number of recording or checkpoint number
+        QString location;   // where target stopped, function and file:line
+    };
+
+    explicit TimeTravel(Gdb* gdb, QObject* parent = 0);
+    void startRecording(int maxInstructions, int maxMarks);
+    void startCheckpoints(int maxCheckpoints);
+    void stop();
+    void rewind(qint64 id);
+    void goToPresent();
+    Mode getMode()const;
+    const std::deque<Mark>& getMarks()const;
+    qint64 getRecorded()const;
+    qint64 getMaxInstructions()const;
+    qint64 getLowest()const;
+    qint64 getHighest()const;
+    qint64 getCurrent()const;
+
+public slots:
+    void slotStopped(const MiRecord& record);
+    void slotBackgroundStopped(const MiRecord& record);
+    void slotNotification(const MiRecord& record);
+
+signals:
+    void signalChanged();
+    void signalRewound(const MiRecord& frame);
+
+private:
+    void readStop(const MiRecord& record, bool background);
+    void selectInferior();
+    void readRecordInfo(const QString& markLocation);
+    void takeCheckpoint(const QString& location);
+    void addMark(qint64 id, const QString& location);
+    void showFrame();
+    void reset();
+
+    Gdb* mGdb;
+    Mode mMode;
+    int mInferior;              // recording and checkpoints are of process focused when they started
+    int mMaxMarks;
+    std::deque<Mark> mMarks;    // the oldest first, bounded by mMaxMarks
+    qint64 mRecorded;
+    qint64 mMaxInstructions;
+    qint64 mLowest;
+    qint64 mHighest;
+    qint64 mCurrent;            // instruction being replayed, 0 when target is live
+};
+
+#endif // TIMETRAVEL_H
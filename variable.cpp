@@ -3,24 +3,127 @@
 #include <QRegExp>
 #include <QDebug>
 #include <QString>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
+#include <QMutexLocker>
 
-Variable::Variable()
+#include <algorithm>
+#include <deque>
+
+namespace
+{
+struct NameEntry
+{
+    int parent;     // -1 for top level names
+    QString leaf;
+    QString full;   // joined once, names are compared and printed much more often than created
+};
+
+struct Interned
+{   // tables of interned names and types. Deque keeps entries in place, so references to them stay valid
+    QMutex mutex;
+    std::deque<NameEntry> names{NameEntry{-1, QString(), QString()}};
+    QHash<QPair<int, QString>, int> nameIds{{qMakePair(-1, QString()), 0}};
+    std::deque<QString> types{QString()};
+    QHash<QString, int> typeIds{{QString(), 0}};
+};
+
+Interned& interned()
+{
+    static Interned tables;
+    return tables;
+}
+
+int internName(int parent, const QString& leaf)
+{   // "list.head.next" is stored as "next" with id of "list.head" as parent
+    Interned& tables = interned();
+    QMutexLocker lock(&tables.mutex);
+    QPair<int, QString> key(parent, leaf);
+    auto found = tables.nameIds.find(key);
+    if(found != tables.nameIds.end())
+    {
+        return found.value();
+    }
+    int id = static_cast<int>(tables.names.size());
+    QString full = parent == -1 ? leaf : tables.names[static_cast<size_t>(parent)].full + '.' + leaf;
+    tables.names.push_back(NameEntry{parent, leaf, full});
+    tables.nameIds.insert(key, id);
+    return id;
+}
+
+int internPath(const QString& name)
+{   // dotted name is interned by parts, so "a.b" has the same id as field "b" of variable "a"
+    int id = -1;
+    for(const QString& i : name.split('.'))
+    {
+        id = internName(id, i);
+    }
+    return id;
+}
+
+const NameEntry& nameAt(int id)
+{
+    Interned& tables = interned();
+    QMutexLocker lock(&tables.mutex);
+    return tables.names[static_cast<size_t>(id)];
+}
+
+int internType(const QString& type)
+{   // the same type name is repeated for thousands of variables, keep it once
+    Interned& tables = interned();
+    QMutexLocker lock(&tables.mutex);
+    auto found = tables.typeIds.find(type);
+    if(found != tables.typeIds.end())
+    {
+        return found.value();
+    }
+    int id = static_cast<int>(tables.types.size());
+    tables.types.push_back(type);
+    tables.typeIds.insert(type, id);
+    return id;
+}
+
+const QString& typeAt(int id)
+{
+    Interned& tables = interned();
+    QMutexLocker lock(&tables.mutex);
+    return tables.types[static_cast<size_t>(id)];
+}
+}
+
+Variable::Variable():
+    mName{0},
+    mType{0},
+    mContentStart{0},
+    mContentLength{0}
 {
 }
 
-Variable::Variable(QString name, QString type, QString content):
-    mName(name),
-    mType(type),
-    mContent(content)
+Variable::Variable(const QString& name, const QString& type, const QString& content):
+    mName{internPath(name)},
+    mType{internType(type)},
+    mBuffer{std::make_shared<const QString>(content)},
+    mContentStart{0},
+    mContentLength{content.size()}
 {
 }
 
+Variable::Variable(const QString &name, const QString &type, const std::shared_ptr<const QString> &buffer, int start, int length):
+    mName{internPath(name)},
+    mType{internType(type)},
+    mBuffer{buffer},
+    mContentStart{start},
+    mContentLength{length}
+{   // content is [$start$, $start$+$length$) of $buffer$, which is shared with other variables
+}
+
 QStringList Variable::getSubVariables() const
 {  // returns list of nested variables in first level
     QRegExp isPointerMatch("\\*");
-    if(isPointerMatch.indexIn(mType) != -1) // if it is pointer
+    if(isPointerMatch.indexIn(getType()) != -1) // if it is pointer
     {
-        QString newName = mName;
+        QString newName = getName();
         newName.prepend('*');
         return QStringList() << newName; // returns only addres of pointed object
     }
@@ -28,9 +131,10 @@ QStringList Variable::getSubVariables() const
     QString currentName;
     QStringList nestedVareables;
     bool capture = true;
-    for(int i=0;i<mContent.size();++i)
+    QStringRef content = getContentRef();
+    for(int i=0;i<content.size();++i)
     {
-        QChar ch = mContent[i];
+        QChar ch = content.at(i);
         /* Control of nesting level */
         if(ch == '{')
         {
@@ -73,51 +177,89 @@ QStringList Variable::getNestedStructures() const
 
 }
 
-QString Variable::getName() const
+const QString &Variable::getName() const
 {
+    return nameAt(mName).full;
+}
+
+const QString &Variable::getLeafName() const
+{
+    return nameAt(mName).leaf;
+}
+
+int Variable::getNameId() const
+{   // variables with the same full name have the same id
     return mName;
 }
 
-QString Variable::getType() const
+const QString &Variable::getType() const
 {
-    return mType;
+    return typeAt(mType);
 }
 
 QString Variable::getContent() const
 {
-    return mContent;
+    return getContentRef().toString();
+}
+
+QStringRef Variable::getContentRef() const
+{   // view valid while this variable is alive
+    return mBuffer ? QStringRef(mBuffer.get(), mContentStart, mContentLength) : QStringRef();
 }
 
 QStringList Variable::readNestedStruct(const QString &vec) const
-{
+{   // returns "key|value" for every field of structure printed by GDB
+    QStringList res;
+    QStringRef text(&vec);
+    for(const Field& i : readNestedFields(text))
+    {
+        res << QString("%1|%2").arg(text.mid(i.keyStart, i.keyLength).toString())
+               .arg(text.mid(i.valueStart, i.valueLength).toString());
+    }
+    return res;
+}
+
+std::vector<Variable::Field> Variable::readNestedFields(const QStringRef &vec)
+{   // find "key = value" pairs on the first level of braces. Only positions are returned,
+    // so nested variables are made without copying text
+    std::vector<Field> fields;
     int level = 0;
     bool capture = true;
-    QString key = "";
-    QString value = "";
-    QStringList res;
+    int keyStart = -1;
+    int keyEnd = -1;
+    int valueStart = -1;
     for (int i = vec.indexOf('{'); i>=0 && i < vec.size(); i++)
     {
-        if (vec[i] == '{') { ++level;}
-        if (vec[i] == '}'){ --level; }
-        QString behind = "";
-        if (i + 2 < vec.size()) behind = vec.mid(i, 2);
-        if (behind == " =" && capture)
+        if (vec.at(i) == '{') { ++level;}
+        if (vec.at(i) == '}'){ --level; }
+        bool assignment = i + 2 < vec.size() && vec.at(i) == ' ' && vec.at(i+1) == '=';
+        if (assignment && capture)
         {
             capture = false;
+            valueStart = i+1;
         }
-        else if (vec[i] == ',' && level == 1 && !capture || i+1 == vec.size())
+        else if (vec.at(i) == ',' && level == 1 && !capture || i+1 == vec.size())
         {
             capture = true;
-            if(key.isEmpty() && value.isEmpty())
+            bool hasKey = keyStart != -1;
+            bool hasValue = valueStart != -1 && i > valueStart;
+            if(!hasKey && !hasValue)
             {
                 break;
             }
-            else if(!key.isEmpty() && !value.isEmpty())
-            {
-                value[0] = ' ';
-                value[1] = ' ';
-                value = value.trimmed();
-                res << QString("%1|%2").arg(key).arg(value);
+            else if(hasKey && hasValue)
+            {   // value is after "= " without surrounding spaces
+                int start = std::min(valueStart+2, i);
+                int end = i;
+                while(start < end && vec.at(start).isSpace())
+                {
+                    ++start;
+                }
+                while(end > start && vec.at(end-1).isSpace())
+                {
+                    --end;
+                }
+                fields.push_back(Field{keyStart, keyEnd-keyStart, start, end-start});
             }
             if(i + 2 < vec.size())
             {
@@ -128,50 +270,59 @@ QStringList Variable::readNestedStruct(const QString &vec) const
             {
                 break;
             }
-            value = "";
-            key = "";
-        }
-        else if(!capture)
-        {
-            value += vec[i];
+            keyStart = -1;
+            keyEnd = -1;
+            valueStart = -1;
         }
         if (capture)
         {
-            if(vec[i] == '{' && key.size() == 0) continue;
-            key += vec[i];
+            if(vec.at(i) == '{' && keyStart == -1) continue;
+            if(keyStart == -1)
+            {
+                keyStart = i;
+            }
+            keyEnd = i+1;
         }
     }
-    return res;
+    return fields;
 }
 
 std::vector<Variable> Variable::getNestedTypes() const
-{
-    QStringList nestedTypeString = readNestedStruct(mContent);
+{   // fields of structure as variables named "parent.field". They share content buffer with this variable
     std::vector<Variable> nestedTypes;
-    for(auto i : nestedTypeString)
+    QStringRef content = getContentRef();
+    std::vector<Field> fields = readNestedFields(content);
+    nestedTypes.reserve(fields.size());
+    static const int unknownType = internType("<No info>");
+    for(const Field& i : fields)
     {
-        QStringList varInfo = i.split('|');
-        if(varInfo.size() == 2)
-        {
-            nestedTypes.emplace_back(QString("%1.%2").arg(mName).arg(varInfo[0]), "<No info>", varInfo[1]);
-        }
+        Variable nested;
+        nested.mName = internName(mName, content.mid(i.keyStart, i.keyLength).toString());
+        nested.mType = unknownType;
+        nested.mBuffer = mBuffer;
+        nested.mContentStart = mContentStart + i.valueStart;
+        nested.mContentLength = i.valueLength;
+        nestedTypes.push_back(std::move(nested));
     }
     return nestedTypes;
 }
 
 void Variable::setType(const QString &type)
 {
-    mType = type;
+    mType = internType(type);
 }
 
 bool Variable::isPointer() const
 {   // check is las character is a star - pointer character
-    int lastStar = mType.lastIndexOf(QString("*"));
-    int lastCharacter = mType.length()-1;
+    const QString& type = getType();
+    int lastStar = type.lastIndexOf(QString("*"));
+    int lastCharacter = type.length()-1;
     return  lastStar == lastCharacter && lastStar != -1;
 }
 
 void Variable::setContent(const QString &content)
 {
-    mContent = content;
+    mBuffer = std::make_shared<const QString>(content);
+    mContentStart = 0;
+    mContentLength = content.size();
 }
@@ -2,18 +2,30 @@
 #define VARIABLE_H
 
 #include <QString>
+#include <QStringList>
+#include <QStringRef>
+
+#include <memory>
 #include <vector>
 
 class Variable
-{
+{   // Variable is a few numbers: type is index of interned type name, name is index of
+    // (parent name, leaf) pair and content is a range of text nested variables share with parent.
+    // Interned names and types live until exit, so ids stay comparable between stops. Their number
+    // is bounded by distinct names and types of the debugged program, not by number of stops
 public:
     Variable();
-    Variable(QString name, QString type, QString content);
+    Variable(const QString& name, const QString& type, const QString& content);
+    Variable(const QString& name, const QString& type,
+             const std::shared_ptr<const QString>& buffer, int start, int length);
     QStringList getSubVariables()const;
     QStringList getNestedStructures()const;
-    QString getName()const;
-    QString getType()const;
+    const QString& getName()const;
+    const QString& getLeafName()const;
+    int getNameId()const;
+    const QString& getType()const;
     QString getContent()const;
+    QStringRef getContentRef()const;
     QStringList readNestedStruct(const QString& vec)const;
 
     std::vector<Variable> getNestedTypes()const;
@@ -21,10 +33,20 @@ public:
     bool isPointer()const;
     void setContent(const QString& content);
 private:
+    struct Field
+    {   // positions of "key = value" in content
+        int keyStart;
+        int keyLength;
+        int valueStart;
+        int valueLength;
+    };
+    static std::vector<Field> readNestedFields(const QStringRef& vec);
 
-    QString mName;
-    QString mType;
-    QString mContent;
+    int mName;
+    int mType;
+    std::shared_ptr<const QString> mBuffer;
+    int mContentStart;
+    int mContentLength;
 };
 
 #endif // VARIABLE_H
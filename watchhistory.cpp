@@ -0,0 +1,134 @@
+#include "watchhistory.h"
+
+#include <QStringList>
+
+WatchHistory::WatchHistory(int capacity):
+    mCapacity{capacity}
+{
+}
+
+bool WatchHistory::readTrigger(const MiRecord &stopped)
+{   //add hit if target stopped by watchpoint. Returns false for other stops
+    /*
+        *stopped,reason="watchpoint-trigger",wpt={number="2",exp="list.size"},value={old="3",new="4"},
+                 frame={addr="0x00401516",func="push",file="list.cpp",line="40"},thread-id="1"
+        *stopped,reason="read-watchpoint-trigger",hw-rwpt={number="3",exp="x"},value={value="5"},...
+        *stopped,reason="access-watchpoint-trigger",hw-awpt={number="4",exp="x"},value={old="5",new="6"},...
+    */
+    QString reason = stopped["reason"].getString();
+    QString key = reason == "watchpoint-trigger" ? "wpt" : reason == "read-watchpoint-trigger" ? "hw-rwpt"
+                : reason == "access-watchpoint-trigger" ? "hw-awpt" : QString();
+    if(key.isEmpty())
+    {
+        return false;
+    }
+    int number = stopped[key]["number"].getString().toInt();
+    const MiValue& value = stopped["value"];
+    const MiValue& frame = stopped["frame"];
+    QString location = frame.contains("file") ? QString("%1:%2").arg(frame["file"].getString())
+                                                .arg(frame["line"].getString()) : QString();
+    int site = internSite(number, frame["func"].getString(), location);
+    ++mSites[site].hits;
+    qint64 index = ++mHitCounts[number];
+    bool changed = value.contains("new");
+    append(Hit{number, index, stopped["thread-id"].getString().toInt(),
+               frame["addr"].getString().toULongLong(nullptr, 0), site,
+               changed ? value["old"].getString() : value["value"].getString(),
+               changed ? value["new"].getString() : value["value"].getString()});
+    return true;
+}
+
+bool WatchHistory::readRecorded(const QString &output)
+{   //add hits printed by uidebugger-watch-history. Counts of sites are totals, so they replace old ones
+    /*
+        history|2|1000000
+        hit|999999|1|0x401516|push|list.cpp:40|3|4
+        site|push|list.cpp:40|1000000
+    */
+    QStringList lines = output.split('\n', QString::SkipEmptyParts);
+    if(lines.isEmpty() || !lines[0].startsWith("history|"))
+    {
+        return false;
+    }
+    QStringList header = lines[0].split('|');
+    int number = header.value(1).toInt();
+    mHitCounts[number] = header.value(2).toLongLong();
+    for(int i=1;i<lines.size();++i)
+    {
+        QStringList fields = lines[i].split('|');
+        if(fields[0] == "hit" && fields.size() == 8)
+        {
+            qint64 index = fields[1].toLongLong();
+            int site = internSite(number, MiRecord::unescapeHelper(fields[4]), MiRecord::unescapeHelper(fields[5]));
+            append(Hit{number, index, fields[2].toInt(), fields[3].toULongLong(nullptr, 0), site,
+                       MiRecord::unescapeHelper(fields[6]), MiRecord::unescapeHelper(fields[7])});
+            mNextIndex[number] = index + 1;
+        }
+        else if(fields[0] == "site" && fields.size() == 4)
+        {
+            int site = internSite(number, MiRecord::unescapeHelper(fields[1]), MiRecord::unescapeHelper(fields[2]));
+            mSites[site].hits = fields[3].toLongLong();
+        }
+    }
+    return true;
+}
+
+void WatchHistory::clear()
+{   //drop hits only. Counts stay and recorded history continues after hits which were read already
+    mHits.clear();
+}
+
+const std::deque<WatchHistory::Hit> &WatchHistory::getHits() const
+{
+    return mHits;
+}
+
+const WatchHistory::Site &WatchHistory::getSite(int site) const
+{
+    return mSites[static_cast<size_t>(site)];
+}
+
+const std::vector<WatchHistory::Site> &WatchHistory::getSites() const
+{
+    return mSites;
+}
+
+qint64 WatchHistory::getHitCount(int watchpoint) const
+{
+    auto found = mHitCounts.find(watchpoint);
+    return found == mHitCounts.end() ? 0 : found->second;
+}
+
+qint64 WatchHistory::getNextIndex(int watchpoint) const
+{
+    auto found = mNextIndex.find(watchpoint);
+    return found == mNextIndex.end() ? 0 : found->second;
+}
+
+int WatchHistory::getCapacity() const
+{
+    return mCapacity;
+}
+
+int WatchHistory::internSite(int watchpoint, const QString &function, const QString &location)
+{
+    QString key = QString("%1|%2|%3").arg(watchpoint).arg(function).arg(location);
+    auto found = mSiteIndex.find(key);
+    if(found != mSiteIndex.end())
+    {
+        return found.value();
+    }
+    mSites.push_back(Site{watchpoint, function, location, 0});
+    int site = static_cast<int>(mSites.size()) - 1;
+    mSiteIndex.insert(key, site);
+    return site;
+}
+
+void WatchHistory::append(const Hit &hit)
+{
+    mHits.push_back(hit);
+    if(static_cast<int>(mHits.size()) > mCapacity)
+    {
+        mHits.pop_front();
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef WATCHHISTORY_H
+#define WATCHHISTORY_H
+
+#include <QString>
+#include <QHash>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "mirecord.h"
+
+class WatchHistory
+{   // values watchpoints saw, the last ones of all watchpoints in one ring buffer. Place of
+    // every hit is an index of interned function and location, so a hit is a few numbers and two values
+public:
+    struct Hit
+    {
+        int watchpoint;
+        qint64 index;       // hit number of watchpoint, gaps mean hits dropped before they were read
+        int thread;
+        quint64 address;
+        int site;
+        QString oldValue;
+        QString newValue;
+    };
+    struct Site
+    {
+        int watchpoint;
+        QString function;
+        QString location;   // file:line, empty without debug info
+        qint64 hits;
+    };
+
+    explicit WatchHistory(int capacity = 100000);
+    bool readTrigger(const MiRecord& stopped);
+    bool readRecorded(const QString& output);
+    void clear();
+    const std::deque<Hit>& getHits()const;
+    const Site& getSite(int site)const;
+    const std::vector<Site>& getSites()const;
+    qint64 getHitCount(int watchpoint)const;
+    qint64 getNextIndex(int watchpoint)const;
+    int getCapacity()const;
+private:
+    int internSite(int watchpoint, const QString& function, const QString& location);
+    void append(const Hit& hit);
+
+    int mCapacity;
+    std::deque<Hit> mHits;
+    std::vector<Site> mSites;
+    QHash<QString, int> mSiteIndex;
+    std::map<int, qint64> mHitCounts;   // all hits including dropped
+    std::map<int, qint64> mNextIndex;   // index recorded history is read from next time
+};
+
+#endif // WATCHHISTORY_H
@@ -0,0 +1,324 @@
+#include "watchlist.h"
+
+static const int childrenWindow = 100; // children are fetched from GDB and shown by windows of this size
+
+WatchList::WatchList(Gdb *gdb, QObject *parent):
+    QObject(parent),
+    mGdb{gdb},
+    mNextId{1},
+    mInferior{gdb->getInferiors().getFocus()}
+{
+    connect(mGdb, SIGNAL(signalStopped(MiRecord)), this, SLOT(slotStopped(MiRecord)), Qt::UniqueConnection);
+    connect(mGdb, SIGNAL(signalFocusChanged(MiRecord)), this, SLOT(slotStopped(MiRecord)), Qt::UniqueConnection);
+}
+
+int WatchList::addWatch(const QString &expression)
+{   // adds watch of $expression$ and returns its id. Other inferiors get it when they are focused
+    int id = mNextId++;
+    mWatches[id] = makeWatch(id, expression);
+    for(auto& i : mOtherWatches)
+    {
+        i.second[id] = mWatches[id];
+    }
+    createVarObject(id);
+    return id;
+}
+
+void WatchList::removeWatch(int id)
+{
+    for(auto& i : mOtherWatches)
+    {
+        auto other = i.second.find(id);
+        if(other != i.second.end())
+        {
+            if(!other->second.varObject.isEmpty())
+            {
+                mGdb->sendCommand(QString("-var-delete %1").arg(other->second.varObject));
+            }
+            i.second.erase(other);
+        }
+    }
+    auto watch = mWatches.find(id);
+    if(watch == mWatches.end())
+    {
+        return;
+    }
+    if(!watch->second.varObject.isEmpty())
+    {
+        mGdb->sendCommand(QString("-var-delete %1").arg(watch->second.varObject));
+        mWatchByVarObject.erase(watch->second.varObject);
+    }
+    mWatches.erase(watch);
+}
+
+const std::map<int, Watch> &WatchList::getWatches() const
+{
+    return mWatches;
+}
+
+void WatchList::update()
+{   // refresh all watches with one -var-update. Watches which GDB couldn't evaluate are created again
+    // only in other function than the one they failed in, so they don't cost a round trip every stop
+    for(auto& i : mWatches)
+    {
+        if(i.second.varObject.isEmpty() && !i.second.creating && i.second.failedScope != mScope)
+        {
+            createVarObject(i.first);
+        }
+    }
+    if(mWatchByVarObject.empty())
+    {
+        return;
+    }
+    mGdb->sendCommand("-var-update --all-values *", [this](const MiRecord& record)
+    {
+        if(record.getClass() == "done")
+        {
+            readChangelist(record["changelist"]);
+        }
+    }, true, CommandScheduler::View, Gdb::getStopGroup());
+}
+
+void WatchList::fetchChildren(const QString &varObject, int from, int total)
+{   // list window of children of $varObject$ starting at $from$. Pretty-printed containers
+    // produce only requested children, so huge containers are paged instead of read at once.
+    // $total$ is number of children for plain variable objects and -1 for pretty-printed ones.
+    // Children of the previous window should be dropped first, they aren't updated any more
+    /*
+        ^done,numchild="2",children=[child={name="var2.[0]",exp="[0]",numchild="0",value="1",type="int",thread-id="1"},
+                                     child={name="var2.[1]",exp="[1]",numchild="0",value="2",type="int",thread-id="1"}],
+             has_more="1"
+    */
+    QString command = QString("-var-list-children --all-values %1 %2 %3")
+            .arg(varObject).arg(from).arg(from + childrenWindow);
+    mGdb->sendCommand(command, [this, varObject, from, total](const MiRecord& record)
+    {
+        if(record.getClass() != "done")
+        {
+            return;
+        }
+        const MiValue& list = record["children"];
+        std::vector<VarChild> children;
+        children.reserve(list.size());
+        for(int i=0;i<list.size();++i)
+        {
+            const MiValue& child = list.at(i);
+            children.push_back(VarChild{child["name"].getString(), child["exp"].getString(),
+                                        child["value"].getString(), child["type"].getString(),
+                                        child["numchild"].getString().toInt(),
+                                        child["dynamic"].getString() == "1",
+                                        child["displayhint"].getString()});
+        }
+        bool hasMore = record["has_more"].getString() == "1" || from + list.size() < total;
+        if(total < 0)
+        {   // otherwise -var-update reports changes of all children pretty-printer has, not only of listed ones
+            mGdb->sendCommand(QString("-var-set-update-range %1 %2 %3").arg(varObject).arg(from).arg(from + list.size()),
+                              Gdb::ResultHandler(), true, CommandScheduler::View, getFetchGroup(varObject));
+        }
+        emit signalChildrenFetched(varObject, from, children, hasMore);
+    }, true, CommandScheduler::View, getFetchGroup(varObject));
+}
+
+void WatchList::dropChildren(const QString &varObject)
+{   // forget listed children of $varObject$, so GDB neither keeps nor updates variable objects nobody looks at
+    mGdb->cancelCommands(getFetchGroup(varObject));
+    mGdb->sendCommand(QString("-var-delete -c %1").arg(varObject), Gdb::ResultHandler(), true, CommandScheduler::View);
+}
+
+void WatchList::slotStopped(const MiRecord& record)
+{
+    const MiValue& frame = record["frame"];
+    mScope = QString("%1@%2").arg(frame["func"].getString()).arg(frame.contains("file") ? frame["file"].getString()
+                                                                                     : frame["from"].getString());
+    int focus = mGdb->getInferiors().getFocus();
+    if(focus != mInferior)
+    {
+        switchInferior(focus);
+    }
+    update();
+}
+
+void WatchList::createVarObject(int id)
+{   // create floating variable object, so it is evaluated in the current frame on every update.
+    // It belongs to inferior focused now, if focus moves meanwhile, it is frozen with that inferior
+    /*
+        ^done,name="var1",numchild="0",value="5",type="int",thread-id="1",has_more="0"
+        ^done,name="var2",numchild="0",value="std::vector of length 3",type="std::vector<int>",
+             thread-id="1",displayhint="array",dynamic="1",has_more="1"
+    */
+    QString expression = mWatches[id].expression;
+    mWatches[id].creating = true;
+    int inferior = mInferior;
+    QString scope = mScope;
+    mGdb->sendCommand(QString("-var-create - @ %1").arg(MiRecord::quote(expression)),
+                      [this, id, inferior, scope](const MiRecord& record)
+    {
+        bool current = inferior == mInferior;
+        std::map<int, Watch>& watches = current ? mWatches : mOtherWatches[inferior];
+        auto watch = watches.find(id);
+        bool created = record.getClass() == "done";
+        if(watch == watches.end())
+        {   // watch was removed while GDB created variable object
+            if(created)
+            {
+                mGdb->sendCommand(QString("-var-delete %1").arg(record["name"].getString()));
+            }
+            return;
+        }
+        Watch& item = watch->second;
+        item.creating = false;
+        if(!item.varObject.isEmpty())
+        {   // watch got variable object already, e.g. by create sent before focus moved
+            if(created)
+            {
+                mGdb->sendCommand(QString("-var-delete %1").arg(record["name"].getString()));
+            }
+            return;
+        }
+        if(created)
+        {
+            item.failedScope.clear();
+            item.varObject = record["name"].getString();
+            item.value = record["value"].getString();
+            item.type = record["type"].getString();
+            item.inScope = true;
+            item.numChildren = record["numchild"].getString().toInt();
+            item.dynamic = record["dynamic"].getString() == "1";
+            item.displayHint = record["displayhint"].getString();
+            if(record["has_more"].getString() == "1" && item.numChildren == 0)
+            {   // pretty-printer knows children only when they are listed
+                item.numChildren = -1;
+            }
+            if(!current)
+            {
+                mGdb->sendCommand(QString("-var-set-frozen %1 1").arg(item.varObject), Gdb::ResultHandler(), false);
+                return;
+            }
+            mWatchByVarObject[item.varObject] = id;
+        }
+        else
+        {
+            item.value = record["msg"].getString();
+            item.inScope = false;
+            item.failedScope = scope;
+        }
+        if(current)
+        {
+            emit signalWatchChanged(id);
+        }
+    });
+}
+
+void WatchList::readChangelist(const MiValue &changelist)
+{   // apply -var-update result. Only watches in changelist changed, so only they are reported
+    /*
+        changelist=[{name="var1",value="6",in_scope="true",type_changed="false",has_more="0"}]
+    */
+    for(int i=0;i<changelist.size();++i)
+    {
+        const MiValue& change = changelist.at(i);
+        QString name = change["name"].getString();
+        bool childrenChanged = change["type_changed"].getString() == "true"
+                || change.contains("new_num_children") || change.contains("new_children");
+        auto found = mWatchByVarObject.find(name);
+        if(found == mWatchByVarObject.end())
+        {   // child of watch which was listed before
+            emit signalVarObjectChanged(name, change["value"].getString(), change["in_scope"].getString() == "true");
+            if(childrenChanged)
+            {
+                emit signalChildrenReset(name);
+            }
+            continue;
+        }
+        Watch& watch = mWatches[found->second];
+        QString inScope = change["in_scope"].getString();
+        if(inScope == "invalid")
+        {   // frame or objfile of variable object is gone, it will be created again on the next stop
+            mGdb->sendCommand(QString("-var-delete %1").arg(watch.varObject));
+            mWatchByVarObject.erase(found);
+            watch.varObject.clear();
+            watch.inScope = false;
+        }
+        else
+        {
+            watch.inScope = inScope == "true";
+            watch.value = change["value"].getString();
+            if(change["type_changed"].getString() == "true")
+            {
+                watch.type = change["new_type"].getString();
+            }
+            if(change.contains("new_num_children"))
+            {
+                watch.numChildren = change["new_num_children"].getString().toInt();
+            }
+            if(change.contains("displayhint"))
+            {
+                watch.displayHint = change["displayhint"].getString();
+            }
+        }
+        emit signalWatchChanged(watch.id);
+        if(childrenChanged)
+        {
+            emit signalChildrenReset(name);
+        }
+    }
+}
+
+void WatchList::switchInferior(int inferior)
+{   // floating variable objects are evaluated in the selected frame, so watches of other process would
+    // get values of focused one and report them as changes. Every inferior has own variable objects,
+    // only ones of focused inferior are unfrozen and updated by "-var-update *"
+    setFrozen(true);
+    std::map<int, Watch> next;
+    auto found = mOtherWatches.find(inferior);
+    if(found != mOtherWatches.end())
+    {
+        next.swap(found->second);
+        mOtherWatches.erase(found);
+    }
+    else
+    {   // variable objects of inferior focused first time are created by update
+        for(const auto& i : mWatches)
+        {
+            next[i.first] = makeWatch(i.first, i.second.expression);
+        }
+    }
+    mOtherWatches[mInferior].swap(mWatches);
+    mWatches.swap(next);
+    mInferior = inferior;
+    mWatchByVarObject.clear();
+    for(const auto& i : mWatches)
+    {
+        if(!i.second.varObject.isEmpty())
+        {
+            mWatchByVarObject[i.second.varObject] = i.first;
+        }
+    }
+    setFrozen(false);
+    for(const auto& i : mWatches)
+    {   // tree shows values of this inferior from now on
+        emit signalWatchChanged(i.first);
+    }
+}
+
+void WatchList::setFrozen(bool frozen)
+{   // frozen variable objects keep values until they are unfrozen, -var-update skips them
+    for(const auto& i : mWatches)
+    {
+        if(!i.second.varObject.isEmpty())
+        {
+            mGdb->sendCommand(QString("-var-set-frozen %1 %2").arg(i.second.varObject).arg(frozen ? 1 : 0),
+                              Gdb::ResultHandler(), false);
+        }
+    }
+}
+
+Watch WatchList::makeWatch(int id, const QString &expression)
+{   // watch without variable object, it is created by update
+    return Watch{id, expression, QString(), QString(), QString(), false, 0, false, QString(), false, QString()};
+}
+
+QString WatchList::getFetchGroup(const QString &varObject)
+{
+    return QString("children:%1").arg(varObject);
+}
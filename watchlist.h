@@ -0,0 +1,77 @@
+#ifndef WATCHLIST_H
+#define WATCHLIST_H
+
+#include <QObject>
+#include <QString>
+
+#include <map>
+#include <vector>
+
+#include "gdb.h"
+
+struct Watch
+{   // watch expression backed by GDB variable object
+    int id;
+    QString expression;
+    QString varObject;  // empty while GDB can't evaluate expression
+    QString value;
+    QString type;
+    bool inScope;
+    int numChildren;
+    bool dynamic;       // value is produced by pretty-printer, children are fetched by ranges
+    QString displayHint; // "map", "array" or "string" from pretty-printer
+    bool creating;      // -var-create is sent and not answered yet
+    QString failedScope; // function where GDB couldn't evaluate expression, it is tried again in other one
+};
+
+struct VarChild
+{
+    QString name;
+    QString expression;
+    QString value;
+    QString type;
+    int numChildren;
+    bool dynamic;
+    QString displayHint;
+};
+
+class WatchList : public QObject
+{
+    Q_OBJECT
+public:
+    explicit WatchList(Gdb* gdb, QObject* parent = 0);
+    int addWatch(const QString& expression);
+    void removeWatch(int id);
+    const std::map<int, Watch>& getWatches()const;
+    void update();
+    void fetchChildren(const QString& varObject, int from, int total);
+    void dropChildren(const QString& varObject);
+
+public slots:
+    void slotStopped(const MiRecord& record);
+
+signals:
+    void signalWatchChanged(int id);
+    void signalVarObjectChanged(const QString& varObject, const QString& value, bool inScope);
+    void signalChildrenReset(const QString& varObject);
+    void signalChildrenFetched(const QString& varObject, int from,
+                               const std::vector<VarChild>& children, bool hasMore);
+
+private:
+    void createVarObject(int id);
+    static Watch makeWatch(int id, const QString& expression);
+    void readChangelist(const MiValue& changelist);
+    void switchInferior(int inferior);
+    void setFrozen(bool frozen);
+    static QString getFetchGroup(const QString& varObject);
+
+    Gdb* mGdb;
+    int mNextId;
+    int mInferior;                  // inferior mWatches belong to
+    QString mScope;                 // function of the last stop
+    std::map<int, Watch> mWatches;
+    std::map<int, std::map<int, Watch>> mOtherWatches;  // the same watches in other inferiors
+    std::map<QString, int> mWatchByVarObject;
+};
+
+#endif // WATCHLIST_H